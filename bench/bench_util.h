@@ -0,0 +1,38 @@
+#pragma once
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <utility>
+
+namespace bench {
+
+//best wall time of `repeats` runs of f, in seconds
+template <class F>
+double best_of(int repeats, F&& f)
+{
+    double best = 1e300;
+    for (int i = 0; i < repeats; i++) {
+        auto start = std::chrono::steady_clock::now();
+        f();
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        if (elapsed.count() < best) {
+            best = elapsed.count();
+        }
+    }
+    return best;
+}
+
+//keeps the optimizer from discarding a computed value
+template <class T>
+void do_not_optimize(const T& value)
+{
+    asm volatile("" : : "r,m"(value) : "memory");
+}
+
+inline std::size_t arg_or(int argc, char* argv[], int index, std::size_t fallback)
+{
+    return argc > index ? std::strtoull(argv[index], nullptr, 10) : fallback;
+}
+
+} //namespace bench
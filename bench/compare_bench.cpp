@@ -0,0 +1,84 @@
+#include "bench_util.h"
+#include "vector.h"
+#include <random>
+#include <cstdint>
+#include <algorithm>
+
+//Compares two equal million-element fingerprint vectors: atl::vector's operator== against the
+//element-wise loop it used before the memcmp fast path. Then orders vectors with operator<
+//against std::lexicographical_compare: long uint32 vectors differing only at the end, and a
+//sort of byte-string keys sharing a common prefix.
+//usage: compare_bench [elements] [repeats] [keys]
+template <class T>
+bool elementwise_equal(const atl::vector<T>& lhs, const atl::vector<T>& rhs)
+{
+    if (lhs.size() != rhs.size()) {
+        return false;
+    }
+    for (auto itL = lhs.begin(), itR = rhs.begin(); itL != lhs.end(); itL++, itR++) {
+        if (*itL != *itR) {
+            return false;
+        }
+    }
+    return true;
+}
+
+template <class F>
+double gigabytes_per_second(std::size_t bytes, std::size_t repeats, F&& compare)
+{
+    auto seconds = bench::best_of(5, [&] {
+        for (std::size_t i = 0; i < repeats; i++) {
+            bench::do_not_optimize(compare());
+        }
+    });
+    return bytes * repeats / seconds / 1e9;
+}
+
+int main(int argc, char* argv[])
+{
+    auto n = bench::arg_or(argc, argv, 1, 1000000);
+    auto repeats = bench::arg_or(argc, argv, 2, 100);
+
+    atl::vector<std::uint64_t> lhs(n);
+    for (std::size_t i = 0; i < n; i++) {
+        lhs[i] = i * 0x9E3779B97F4A7C15ull;
+    }
+    auto rhs = lhs;
+    auto bytes = n * sizeof(std::uint64_t);
+
+    std::printf("%zu uint64 elements, GB/s of one operand scanned\n", n);
+    std::printf("element-wise ==  %6.2f\n", gigabytes_per_second(bytes, repeats, [&] { return elementwise_equal(lhs, rhs); }));
+    std::printf("operator==       %6.2f\n", gigabytes_per_second(bytes, repeats, [&] { return lhs == rhs; }));
+
+    atl::vector<std::uint32_t> words(n, 42);
+    auto last_differs = words;
+    last_differs.back() = 43;
+    auto std_less = [](const auto& a, const auto& b) {
+        return std::lexicographical_compare(a.begin(), a.end(), b.begin(), b.end());
+    };
+    bytes = n * sizeof(std::uint32_t);
+    std::printf("\n%zu uint32 elements, mismatch at the end, GB/s\n", n);
+    std::printf("std::lexicographical_compare  %6.2f\n", gigabytes_per_second(bytes, repeats, [&] { return std_less(words, last_differs); }));
+    std::printf("operator<                     %6.2f\n", gigabytes_per_second(bytes, repeats, [&] { return words < last_differs; }));
+
+    auto key_count = bench::arg_or(argc, argv, 3, 1000000);
+    std::mt19937_64 random(1);
+    atl::vector<atl::vector<std::uint8_t>> keys(key_count);
+    for (auto& key : keys) {
+        key.assign(12, 0xAB);
+        for (int i = 0; i < 8; i++) {
+            key.push_back(static_cast<std::uint8_t>(random()));
+        }
+    }
+    auto sort_seconds = [&](auto less) {
+        return bench::best_of(3, [&] {
+            auto copy = keys;
+            std::sort(copy.begin(), copy.end(), less);
+            bench::do_not_optimize(copy.front().data());
+        });
+    };
+    std::printf("\nsort of %zu 20-byte keys, seconds\n", key_count);
+    std::printf("std::lexicographical_compare  %6.3f\n", sort_seconds(std_less));
+    std::printf("operator<                     %6.3f\n", sort_seconds([](const auto& a, const auto& b) { return a < b; }));
+    return EXIT_SUCCESS;
+}
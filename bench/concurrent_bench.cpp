@@ -0,0 +1,64 @@
+#include "bench_util.h"
+#include "vector.h"
+#include "concurrent_vector.h"
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <algorithm>
+
+//Appends from 1..N threads: a mutex-guarded atl::vector against atl::concurrent_vector.
+//usage: concurrent_bench [total appends] [max threads]
+struct locked_vector
+{
+    atl::vector<std::size_t> values;
+    std::mutex mutex;
+
+    void append(std::size_t i)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        values.push_back(i);
+    }
+};
+
+struct lock_free_vector
+{
+    atl::concurrent_vector<std::size_t> values;
+
+    void append(std::size_t i) { values.push_back(i); }
+};
+
+template <class Container>
+double appends_per_second(unsigned threads, std::size_t total)
+{
+    auto seconds = bench::best_of(3, [&] {
+        Container container;
+        std::vector<std::thread> workers;
+        for (unsigned t = 0; t < threads; t++) {
+            workers.emplace_back([&container, t, threads, total] {
+                for (std::size_t i = t; i < total; i += threads) {
+                    container.append(i);
+                }
+            });
+        }
+        for (auto& worker : workers) {
+            worker.join();
+        }
+        bench::do_not_optimize(container.values.size());
+    });
+    return total / seconds;
+}
+
+int main(int argc, char* argv[])
+{
+    auto total = bench::arg_or(argc, argv, 1, 10000000);
+    auto max_threads = bench::arg_or(argc, argv, 2, std::max(1u, std::thread::hardware_concurrency()));
+
+    std::printf("%zu appends, Mappends/s\n", total);
+    std::printf("threads  mutex+atl::vector  atl::concurrent_vector\n");
+    for (unsigned threads = 1; threads <= max_threads; threads++) {
+        std::printf("%7u  %17.1f  %22.1f\n", threads,
+                    appends_per_second<locked_vector>(threads, total) / 1e6,
+                    appends_per_second<lock_free_vector>(threads, total) / 1e6);
+    }
+    return EXIT_SUCCESS;
+}
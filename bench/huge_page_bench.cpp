@@ -0,0 +1,58 @@
+#include "bench_util.h"
+#include "vector.h"
+#include "huge_page_allocator.h"
+#include <random>
+
+//Random gather over a large vector<double> with and without huge pages.
+//usage: huge_page_bench [elements] [lookups]
+template <class Vector>
+double gather(const Vector& values, const atl::vector<std::uint32_t>& indices)
+{
+    return bench::best_of(5, [&] {
+        double sum = 0;
+        for (auto index : indices) {
+            sum += values[index];
+        }
+        bench::do_not_optimize(sum);
+    });
+}
+
+template <class Vector>
+Vector make_values(std::size_t elements)
+{
+    Vector values;
+    values.reserve(elements);
+    for (std::size_t i = 0; i < elements; i++) {
+        values.push_back(static_cast<double>(i));
+    }
+    return values;
+}
+
+int main(int argc, char* argv[])
+{
+    auto elements = bench::arg_or(argc, argv, 1, std::size_t(1) << 27); //1 GB of doubles
+    auto lookups  = bench::arg_or(argc, argv, 2, std::size_t(1) << 24);
+
+    std::mt19937 rng(42);
+    std::uniform_int_distribution<std::uint32_t> dist(0, static_cast<std::uint32_t>(elements - 1));
+    atl::vector<std::uint32_t> indices;
+    indices.reserve(lookups);
+    for (std::size_t i = 0; i < lookups; i++) {
+        indices.push_back(dist(rng));
+    }
+
+    double regular_time, huge_time;
+    {
+        auto values = make_values<atl::vector<double>>(elements);
+        regular_time = gather(values, indices);
+    }
+    {
+        auto values = make_values<atl::vector<double, atl::huge_page_allocator<double>>>(elements);
+        huge_time = gather(values, indices);
+    }
+
+    std::printf("elements: %zu, lookups: %zu\n", elements, lookups);
+    std::printf("std::allocator       : %8.2f Mlookups/s\n", lookups / regular_time / 1e6);
+    std::printf("huge_page_allocator  : %8.2f Mlookups/s\n", lookups / huge_time / 1e6);
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,64 @@
+#include "bench_util.h"
+#include "vector.h"
+#include "parallel.h"
+#include <cmath>
+#include <thread>
+#include <numeric>
+#include <algorithm>
+
+//Runs for_each, transform, reduce and count_if over one atl::vector<double> on pools of
+//1..N threads and prints throughput and the speedup over the single-threaded pool.
+//usage: parallel_bench [elements] [max threads]
+struct timings
+{
+    double for_each;
+    double transform;
+    double reduce;
+    double count_if;
+};
+
+timings run(std::size_t threads, atl::vector<double>& values, atl::vector<double>& out)
+{
+    atl::parallel::thread_pool pool(threads);
+    timings t;
+    t.for_each = bench::best_of(5, [&] {
+        atl::parallel::for_each(pool, values, [](double& x) { x = x * 1.0000001 + 0.5; });
+    });
+    t.transform = bench::best_of(5, [&] {
+        atl::parallel::transform(pool, values, out, [](double x) { return std::sqrt(x); });
+        bench::do_not_optimize(out.data());
+    });
+    t.reduce = bench::best_of(5, [&] {
+        bench::do_not_optimize(atl::parallel::reduce(pool, values, 0.0, [](double a, double b) { return a + b; }));
+    });
+    t.count_if = bench::best_of(5, [&] {
+        bench::do_not_optimize(atl::parallel::count_if(pool, values, [](double x) { return x > 1000.0; }));
+    });
+    return t;
+}
+
+int main(int argc, char* argv[])
+{
+    auto n = bench::arg_or(argc, argv, 1, 1 << 24);
+    auto max_threads = bench::arg_or(argc, argv, 2, std::max(1u, std::thread::hardware_concurrency()));
+
+    atl::vector<double> values(n);
+    std::iota(values.begin(), values.end(), 0.0);
+    atl::vector<double> out;
+
+    std::printf("%zu doubles, Melems/s (speedup over 1 thread)\n", n);
+    std::printf("threads          for_each         transform            reduce          count_if\n");
+    timings base{};
+    for (std::size_t threads = 1; threads <= max_threads; threads++) {
+        auto t = run(threads, values, out);
+        if (threads == 1) {
+            base = t;
+        }
+        std::printf("%7zu  %8.1f (%4.2fx)  %8.1f (%4.2fx)  %8.1f (%4.2fx)  %8.1f (%4.2fx)\n", threads,
+                    n / t.for_each / 1e6, base.for_each / t.for_each,
+                    n / t.transform / 1e6, base.transform / t.transform,
+                    n / t.reduce / 1e6, base.reduce / t.reduce,
+                    n / t.count_if / 1e6, base.count_if / t.count_if);
+    }
+    return EXIT_SUCCESS;
+}
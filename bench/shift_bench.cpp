@@ -0,0 +1,56 @@
+#include "bench_util.h"
+#include "vector.h"
+#include <string>
+#include <vector>
+
+//Front insertion and middle erasure against std::vector.
+//usage: shift_bench [elements]
+template <class Vector, class Make>
+double front_insert(std::size_t elements, Make make)
+{
+    return bench::best_of(3, [&] {
+        Vector values;
+        for (std::size_t i = 0; i < elements; i++) {
+            values.insert(values.begin(), make(i));
+        }
+        bench::do_not_optimize(values.size());
+    });
+}
+
+template <class Vector, class Make>
+double middle_erase(std::size_t elements, Make make)
+{
+    Vector source;
+    for (std::size_t i = 0; i < elements; i++) {
+        source.push_back(make(i));
+    }
+
+    return bench::best_of(3, [&] {
+        Vector values = source;
+        while (!values.empty()) {
+            values.erase(values.begin() + values.size() / 2);
+        }
+        bench::do_not_optimize(values.size());
+    });
+}
+
+template <class T, class Make>
+void run(const char* name, std::size_t elements, Make make)
+{
+    std::printf("%s, %zu elements\n", name, elements);
+    std::printf("  front insert  atl::vector: %8.2f ms   std::vector: %8.2f ms\n",
+                front_insert<atl::vector<T>>(elements, make) * 1e3,
+                front_insert<std::vector<T>>(elements, make) * 1e3);
+    std::printf("  middle erase  atl::vector: %8.2f ms   std::vector: %8.2f ms\n",
+                middle_erase<atl::vector<T>>(elements, make) * 1e3,
+                middle_erase<std::vector<T>>(elements, make) * 1e3);
+}
+
+int main(int argc, char* argv[])
+{
+    auto elements = bench::arg_or(argc, argv, 1, 50000);
+
+    run<int>("int", elements, [](std::size_t i) { return static_cast<int>(i); });
+    run<std::string>("std::string", elements / 10, [](std::size_t i) { return std::to_string(i); });
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,114 @@
+#include "bench_util.h"
+#include "vector.h"
+#include "spsc_ring.h"
+#include <mutex>
+#include <thread>
+#include <vector>
+
+//Hands items from a producer thread to a consumer thread: a mutex-guarded atl::vector that
+//the consumer swaps out, against atl::spsc_ring with single and batched operations. Also
+//measures the round-trip latency of one item bounced through two rings.
+//usage: spsc_bench [items] [batch]
+double locked_vector(std::size_t items, std::size_t batch)
+{
+    return bench::best_of(3, [&] {
+        atl::vector<std::size_t> shared;
+        std::mutex mutex;
+
+        std::thread producer([&] {
+            for (std::size_t i = 0; i < items; i += batch) {
+                std::lock_guard<std::mutex> lock(mutex);
+                for (std::size_t j = i; j < std::min(items, i + batch); j++) {
+                    shared.push_back(j);
+                }
+            }
+        });
+
+        atl::vector<std::size_t> local;
+        std::size_t received = 0;
+        while (received < items) {
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                local.swap(shared);
+            }
+            if (local.empty()) {
+                std::this_thread::yield();
+            }
+            received += local.size();
+            local.clear();
+        }
+        producer.join();
+        bench::do_not_optimize(received);
+    });
+}
+
+double ring(std::size_t items, std::size_t batch)
+{
+    return bench::best_of(3, [&] {
+        atl::spsc_ring<std::size_t> ring(4096);
+
+        std::thread producer([&] {
+            std::vector<std::size_t> values(batch);
+            for (std::size_t i = 0; i < items;) {
+                auto n = std::min(batch, items - i);
+                auto pushed = batch == 1 ? static_cast<std::size_t>(ring.try_push(i)) : ring.push_n(values.begin(), n);
+                if (pushed == 0) {
+                    std::this_thread::yield();
+                }
+                i += pushed;
+            }
+        });
+
+        std::vector<std::size_t> out(batch);
+        std::size_t received = 0;
+        while (received < items) {
+            auto popped = batch == 1 ? static_cast<std::size_t>(ring.try_pop(out[0])) : ring.pop_n(out.begin(), batch);
+            if (popped == 0) {
+                std::this_thread::yield();
+            }
+            received += popped;
+        }
+        producer.join();
+        bench::do_not_optimize(received);
+    });
+}
+
+double round_trip(std::size_t trips)
+{
+    return bench::best_of(3, [&] {
+        atl::spsc_ring<std::size_t> ping(64);
+        atl::spsc_ring<std::size_t> pong(64);
+
+        std::thread echo([&] {
+            std::size_t value;
+            for (std::size_t i = 0; i < trips; i++) {
+                while (!ping.try_pop(value)) {
+                    std::this_thread::yield();
+                }
+                pong.try_push(value);
+            }
+        });
+
+        std::size_t value;
+        for (std::size_t i = 0; i < trips; i++) {
+            ping.try_push(i);
+            while (!pong.try_pop(value)) {
+                std::this_thread::yield();
+            }
+        }
+        echo.join();
+    }) / trips;
+}
+
+int main(int argc, char* argv[])
+{
+    auto items = bench::arg_or(argc, argv, 1, 10000000);
+    auto batch = bench::arg_or(argc, argv, 2, 64);
+
+    std::printf("%zu items, Mitems/s\n", items);
+    std::printf("  mutex+atl::vector, batch %3zu: %8.1f\n", batch, items / locked_vector(items, batch) / 1e6);
+    std::printf("  spsc_ring, single          : %8.1f\n", items / ring(items, 1) / 1e6);
+    std::printf("  spsc_ring, batch %3zu       : %8.1f\n", batch, items / ring(items, batch) / 1e6);
+    std::printf("  spsc_ring round trip       : %8.1f ns\n", round_trip(items / 100) * 1e9);
+    return EXIT_SUCCESS;
+}
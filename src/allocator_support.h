@@ -0,0 +1,78 @@
+#pragma once
+
+#include <memory>
+#include <type_traits>
+
+namespace atl {
+
+//Optional allocator extensions understood by atl containers.
+//
+//  allocation_result reallocate(pointer p, size_type old_n, size_type new_n);
+//      Resizes the block p of old_n elements to new_n elements with realloc semantics:
+//      the contents are preserved bitwise (the block may move), and on failure a null ptr is
+//      returned with p left untouched. count >= new_n is the usable size of the resized
+//      block, as for allocate_at_least. Returning a plain pointer instead is also accepted
+//      and means count == new_n. Only used for trivially relocatable value types.
+//
+//  allocation_result allocate_at_least(size_type n);
+//      C++23 semantics: returns {ptr, count} with count >= n usable elements. The block is
+//      later released with deallocate(ptr, count). Containers record count as their capacity.
+
+template <class Pointer, class SizeType = std::size_t>
+struct allocation_result
+{
+    Pointer  ptr;
+    SizeType count;
+};
+
+template <class Allocator, class = void>
+struct has_reallocate : std::false_type {};
+
+template <class Allocator>
+struct has_reallocate<Allocator, std::void_t<decltype(std::declval<Allocator&>().reallocate(
+        std::declval<typename std::allocator_traits<Allocator>::pointer>(),
+        std::declval<typename std::allocator_traits<Allocator>::size_type>(),
+        std::declval<typename std::allocator_traits<Allocator>::size_type>()))>> : std::true_type {};
+
+template <class Allocator>
+constexpr bool has_reallocate_v = has_reallocate<Allocator>::value;
+
+template <class Allocator, class = void>
+struct has_allocate_at_least : std::false_type {};
+
+template <class Allocator>
+struct has_allocate_at_least<Allocator, std::void_t<decltype(std::declval<Allocator&>().allocate_at_least(
+        std::declval<typename std::allocator_traits<Allocator>::size_type>()))>> : std::true_type {};
+
+template <class Allocator>
+constexpr bool has_allocate_at_least_v = has_allocate_at_least<Allocator>::value;
+
+//Calls alloc.allocate_at_least(n) when available, plain allocate(n) otherwise.
+template <class Allocator>
+allocation_result<typename std::allocator_traits<Allocator>::pointer, typename std::allocator_traits<Allocator>::size_type>
+allocate_at_least(Allocator& alloc, typename std::allocator_traits<Allocator>::size_type n)
+{
+    if constexpr (has_allocate_at_least_v<Allocator>) {
+        auto result = alloc.allocate_at_least(n);
+        return {result.ptr, result.count};
+    } else {
+        return {std::allocator_traits<Allocator>::allocate(alloc, n), n};
+    }
+}
+
+//Calls alloc.reallocate(p, old_n, new_n) and returns {ptr, count} whichever form it has.
+template <class Allocator>
+allocation_result<typename std::allocator_traits<Allocator>::pointer, typename std::allocator_traits<Allocator>::size_type>
+reallocate_at_least(Allocator& alloc, typename std::allocator_traits<Allocator>::pointer p,
+                    typename std::allocator_traits<Allocator>::size_type old_n,
+                    typename std::allocator_traits<Allocator>::size_type new_n) noexcept
+{
+    auto result = alloc.reallocate(p, old_n, new_n);
+    if constexpr (std::is_convertible<decltype(result), typename std::allocator_traits<Allocator>::pointer>::value) {
+        return {result, new_n};
+    } else {
+        return {result.ptr, result.count};
+    }
+}
+
+} //namespace atl
@@ -0,0 +1,12 @@
+#pragma once
+
+#include <cstddef>
+
+namespace atl {
+
+//Size used to keep independently written atomics on separate cache lines. A constant rather
+//than std::hardware_destructive_interference_size, whose value GCC warns may change between
+//compiler versions and so is unfit for a header-only library's layout.
+inline constexpr std::size_t cache_line_size = 64;
+
+} //namespace atl
@@ -0,0 +1,133 @@
+#pragma once
+
+#include <cstddef>
+#include <cstring>
+#include <memory>
+#include <type_traits>
+
+namespace atl {
+
+//Types whose operator== holds exactly when the object representations are equal, so ranges
+//of them can be compared with a single memcmp. Integers, enums and pointers qualify
+//automatically (floating point does not: 0.0 == -0.0 and NaN != NaN); specialize for your
+//own padding-free types whose operator== compares every byte, e.g.
+//
+//    template <> struct atl::is_trivially_equality_comparable<Fingerprint> : std::true_type {};
+template <class T>
+struct is_trivially_equality_comparable
+        : std::integral_constant<bool, std::has_unique_object_representations<T>::value &&
+                                       (std::is_integral<T>::value || std::is_enum<T>::value || std::is_pointer<T>::value)> {};
+
+template <class T>
+constexpr bool is_trivially_equality_comparable_v = is_trivially_equality_comparable<T>::value;
+
+namespace detail {
+
+//Whether first[0, n) and other[0, n) compare equal element by element.
+template <class Pointer>
+bool equal_n(Pointer first, Pointer other, std::size_t n)
+{
+    using T = typename std::pointer_traits<Pointer>::element_type;
+
+    if (n == 0) {
+        return true;
+    }
+
+    if constexpr (is_trivially_equality_comparable_v<typename std::remove_cv<T>::type>) {
+        return std::memcmp(static_cast<const void*>(std::addressof(*first)),
+                           static_cast<const void*>(std::addressof(*other)),
+                           n * sizeof(T)) == 0;
+    } else {
+        for (std::size_t i = 0; i < n; i++) {
+            if (first[i] != other[i]) {
+                return false;
+            }
+        }
+        return true;
+    }
+}
+
+//Index of the first position where first[i] and other[i] differ, or n. Scans blocks of one
+//cache line with a branch-free reduction (OR of XORs for integers) that the compiler turns
+//into vector code, and only walks a block element by element once it holds a difference.
+//Floating-point elements differ when either is less than the other, so NaNs are skipped as
+//std::lexicographical_compare skips them.
+template <class T>
+std::size_t mismatch_index(const T* first, const T* other, std::size_t n)
+{
+    constexpr std::size_t block = sizeof(T) < 64 ? 64 / sizeof(T) : 1;
+    auto differ = [](const T& lhs, const T& rhs) {
+        if constexpr (std::is_floating_point<T>::value) {
+            return (lhs < rhs) | (rhs < lhs);
+        } else {
+            return lhs != rhs;
+        }
+    };
+
+    std::size_t i = 0;
+    for (; i + block <= n; i += block) {
+        bool any = false;
+        if constexpr (std::is_integral<T>::value && !std::is_same<T, bool>::value) {
+            typename std::make_unsigned<T>::type bits = 0;
+            for (std::size_t j = 0; j < block; j++) {
+                bits |= first[i + j] ^ other[i + j];
+            }
+            any = bits != 0;
+        } else {
+            for (std::size_t j = 0; j < block; j++) {
+                any |= differ(first[i + j], other[i + j]);
+            }
+        }
+        if (any) {
+            break;
+        }
+    }
+    for (; i < n; i++) {
+        if (differ(first[i], other[i])) {
+            return i;
+        }
+    }
+    return n;
+}
+
+//Lexicographic three-way comparison of first[0, n) and other[0, m): negative, zero or
+//positive as the first range orders before, equivalent to or after the second. Unsigned
+//bytes compare with memcmp, other arithmetic types through mismatch_index, and everything
+//else element by element with operator< alone.
+template <class Pointer>
+int compare_n(Pointer first, std::size_t n, Pointer other, std::size_t m)
+{
+    using T = typename std::remove_cv<typename std::pointer_traits<Pointer>::element_type>::type;
+    auto common = n < m ? n : m;
+
+    if (common != 0) {
+        if constexpr ((std::is_unsigned<T>::value && sizeof(T) == 1) || std::is_same<T, std::byte>::value) {
+            auto result = std::memcmp(static_cast<const void*>(std::addressof(*first)),
+                                      static_cast<const void*>(std::addressof(*other)),
+                                      common);
+            if (result != 0) {
+                return result;
+            }
+        } else if constexpr (std::is_arithmetic<T>::value) {
+            auto lhs = std::addressof(*first);
+            auto rhs = std::addressof(*other);
+            auto i = mismatch_index<T>(lhs, rhs, common);
+            if (i != common) {
+                return lhs[i] < rhs[i] ? -1 : 1;
+            }
+        } else {
+            for (std::size_t i = 0; i < common; i++) {
+                if (first[i] < other[i]) {
+                    return -1;
+                }
+                if (other[i] < first[i]) {
+                    return 1;
+                }
+            }
+        }
+    }
+    return n < m ? -1 : (m < n ? 1 : 0);
+}
+
+} //namespace detail
+} //namespace atl
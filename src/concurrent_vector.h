@@ -0,0 +1,329 @@
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <limits>
+#include <cstddef>
+#include <utility>
+#include <iterator>
+#include <stdexcept>
+#include <type_traits>
+#include "indexed_iterator.h"
+#include "segmented_vector.h"
+
+namespace atl {
+
+//Append-only vector that many threads may grow at once without locking. An append first
+//installs the segments its slots will live in, then claims the slots with a compare-exchange
+//on the size and constructs them in place, so a claimed slot always has storage. Storage is
+//the segment layout of segmented_vector, and a missing segment is installed with a
+//compare-exchange too (a thread that loses the race frees its own block), so elements never
+//move and their addresses stay valid.
+//
+//An element may be read concurrently once the thread that appended it has published it, e.g.
+//by handing over the returned iterator or by joining. size() counts claimed slots, which can
+//include elements still under construction. clear(), swap and destruction are not thread-safe.
+//The allocator must be safe to call from several threads.
+//
+//Every slot carries a state next to it, set with release once the element is constructed.
+//constructed(n) reads it with acquire, so a reader that does not otherwise synchronize with
+//the appending thread checks it before touching element n, and at() throws unless it holds.
+//If constructing an element throws, its slot is already visible to other threads and cannot
+//be given back: it and every later slot claimed by the same call are marked failed and hold
+//no object, and constructed() stays false for them. Allocation failures and length_error are
+//thrown before any slot is claimed.
+template <class T, class Allocator = std::allocator<T>, std::size_t FirstSegment = 64>
+class concurrent_vector {
+    using layout = detail::segment_layout<FirstSegment>;
+
+public:
+    // types:
+    using value_type             = T;
+    using reference              = value_type&;
+    using const_reference        = const value_type&;
+    using size_type              = std::size_t;
+    using difference_type        = std::ptrdiff_t;
+
+    using allocator_type         = Allocator;
+    using pointer                = typename std::allocator_traits<Allocator>::pointer;
+    using const_pointer          = typename std::allocator_traits<Allocator>::const_pointer;
+    using iterator               = IndexedIterator<concurrent_vector, false>;
+    using const_iterator         = IndexedIterator<concurrent_vector, true>;
+
+    // construct/destroy:
+    explicit concurrent_vector(const Allocator& alloc = Allocator()) noexcept;
+    concurrent_vector(const concurrent_vector&) = delete;
+    concurrent_vector& operator=(const concurrent_vector&) = delete;
+    ~concurrent_vector();
+
+    allocator_type get_allocator() const noexcept { return allocator_; }
+
+    // iterators (cover the elements claimed when begin()/end() is called):
+    iterator       begin() noexcept        { return iterator(this, 0); }
+    const_iterator begin() const noexcept  { return const_iterator(this, 0); }
+    iterator       end() noexcept          { return iterator(this, size()); }
+    const_iterator end() const noexcept    { return const_iterator(this, size()); }
+    const_iterator cbegin() const noexcept { return begin(); }
+    const_iterator cend() const noexcept   { return end(); }
+
+    // capacity:
+    size_type size() const noexcept  { return size_.load(std::memory_order_acquire); }
+    bool      empty() const noexcept { return size() == 0; }
+    void      reserve(size_type capacity);
+
+    //whether element n < size() exists: false while it is under construction or if its
+    //constructor threw
+    bool constructed(size_type n) const noexcept;
+
+    // element access:
+    reference       operator[](size_type n)       { return *element(n); }
+    const_reference operator[](size_type n) const { return *element(n); }
+    reference       at(size_type pos);
+    const_reference at(size_type pos) const;
+
+    // concurrent modifiers:
+    template <class... Args> iterator emplace_back(Args&& ...args);
+    iterator push_back(const T& elem) { return emplace_back(elem); }
+    iterator push_back(T&& elem)      { return emplace_back(std::move(elem)); }
+    //appends n value-initialized (or copied) elements in consecutive slots
+    iterator grow_by(size_type n);
+    iterator grow_by(size_type n, const T& elem);
+
+    // not thread-safe:
+    void clear() noexcept;
+
+private:
+    using state_type      = std::atomic<unsigned char>;
+    using state_allocator = typename std::allocator_traits<Allocator>::template rebind_alloc<state_type>;
+    using state_pointer   = typename std::allocator_traits<state_allocator>::pointer;
+
+    enum : unsigned char { slot_claimed, slot_constructed, slot_failed };
+
+    Allocator allocator_;
+    std::atomic<pointer> segments_[layout::max_segments];
+    std::atomic<state_pointer> states_[layout::max_segments];
+    std::atomic<size_type> size_;
+
+    pointer     element(size_type index) const noexcept;
+    state_type& state(size_type index) const noexcept;
+    void    install(size_type segment);
+    size_type claim(size_type n);
+    void    mark_failed(size_type first, size_type last) noexcept;
+    template <class... Args> void construct(size_type index, Args&&... args);
+    template <class... Args> void construct_n(size_type first, size_type n, const Args&... args);
+};
+
+template<class T, class Allocator, std::size_t FirstSegment>
+concurrent_vector<T, Allocator, FirstSegment>::concurrent_vector(const Allocator& alloc) noexcept
+        : allocator_(alloc),
+          size_(0)
+{
+    for (auto& segment : segments_) {
+        segment.store(nullptr, std::memory_order_relaxed);
+    }
+    for (auto& states : states_) {
+        states.store(nullptr, std::memory_order_relaxed);
+    }
+}
+
+template<class T, class Allocator, std::size_t FirstSegment>
+concurrent_vector<T, Allocator, FirstSegment>::~concurrent_vector()
+{
+    clear();
+    for (size_type i = 0; i < layout::max_segments; i++) {
+        auto block = segments_[i].load(std::memory_order_relaxed);
+        if (block != nullptr) {
+            std::allocator_traits<Allocator>::deallocate(allocator_, block, layout::segment_size(i));
+        }
+        auto states = states_[i].load(std::memory_order_relaxed);
+        if (states != nullptr) {
+            state_allocator alloc(allocator_);
+            std::allocator_traits<state_allocator>::deallocate(alloc, states, layout::segment_size(i));
+        }
+    }
+}
+
+template<class T, class Allocator, std::size_t FirstSegment>
+void concurrent_vector<T, Allocator, FirstSegment>::reserve(size_type capacity)
+{
+    if (capacity == 0) {
+        return;
+    }
+    if (capacity > std::numeric_limits<size_type>::max() - FirstSegment) {
+        throw std::length_error("concurrent_vector is full");
+    }
+    for (size_type i = 0, last = layout::segment_of(capacity - 1); i <= last; i++) {
+        install(i);
+    }
+}
+
+template<class T, class Allocator, std::size_t FirstSegment>
+bool concurrent_vector<T, Allocator, FirstSegment>::constructed(size_type n) const noexcept
+{
+    return state(n).load(std::memory_order_acquire) == slot_constructed;
+}
+
+template<class T, class Allocator, std::size_t FirstSegment>
+typename concurrent_vector<T, Allocator, FirstSegment>::reference concurrent_vector<T, Allocator, FirstSegment>::at(size_type pos)
+{
+    if (size() <= pos) {
+        throw std::out_of_range("Index out of range");
+    }
+    if (!constructed(pos)) {
+        throw std::out_of_range("Element not constructed");
+    }
+    return *element(pos);
+}
+
+template<class T, class Allocator, std::size_t FirstSegment>
+typename concurrent_vector<T, Allocator, FirstSegment>::const_reference concurrent_vector<T, Allocator, FirstSegment>::at(size_type pos) const
+{
+    if (size() <= pos) {
+        throw std::out_of_range("Index out of range");
+    }
+    if (!constructed(pos)) {
+        throw std::out_of_range("Element not constructed");
+    }
+    return *element(pos);
+}
+
+template<class T, class Allocator, std::size_t FirstSegment>
+template<class... Args>
+typename concurrent_vector<T, Allocator, FirstSegment>::iterator concurrent_vector<T, Allocator, FirstSegment>::emplace_back(Args&& ...args)
+{
+    auto index = claim(1);
+    construct(index, std::forward<Args>(args)...);
+    return iterator(this, index);
+}
+
+template<class T, class Allocator, std::size_t FirstSegment>
+typename concurrent_vector<T, Allocator, FirstSegment>::iterator concurrent_vector<T, Allocator, FirstSegment>::grow_by(size_type n)
+{
+    auto first = claim(n);
+    construct_n(first, n);
+    return iterator(this, first);
+}
+
+template<class T, class Allocator, std::size_t FirstSegment>
+typename concurrent_vector<T, Allocator, FirstSegment>::iterator concurrent_vector<T, Allocator, FirstSegment>::grow_by(size_type n, const T& elem)
+{
+    auto first = claim(n);
+    construct_n(first, n, elem);
+    return iterator(this, first);
+}
+
+template<class T, class Allocator, std::size_t FirstSegment>
+void concurrent_vector<T, Allocator, FirstSegment>::clear() noexcept
+{
+    auto size = size_.load(std::memory_order_relaxed);
+    for (size_type i = 0; i < size; i++) {
+        if (state(i).load(std::memory_order_relaxed) == slot_constructed) {
+            std::allocator_traits<Allocator>::destroy(allocator_, std::addressof(*element(i)));
+        }
+        state(i).store(slot_claimed, std::memory_order_relaxed);
+    }
+    size_.store(0, std::memory_order_relaxed);
+}
+
+template<class T, class Allocator, std::size_t FirstSegment>
+typename concurrent_vector<T, Allocator, FirstSegment>::pointer concurrent_vector<T, Allocator, FirstSegment>::element(size_type index) const noexcept
+{
+    auto segment = layout::segment_of(index);
+    return segments_[segment].load(std::memory_order_acquire) + layout::offset_in(index, segment);
+}
+
+template<class T, class Allocator, std::size_t FirstSegment>
+typename concurrent_vector<T, Allocator, FirstSegment>::state_type& concurrent_vector<T, Allocator, FirstSegment>::state(size_type index) const noexcept
+{
+    auto segment = layout::segment_of(index);
+    return *(states_[segment].load(std::memory_order_acquire) + layout::offset_in(index, segment));
+}
+
+//Installs the given segment and its slot states unless another thread already has.
+template<class T, class Allocator, std::size_t FirstSegment>
+void concurrent_vector<T, Allocator, FirstSegment>::install(size_type segment)
+{
+    if (states_[segment].load(std::memory_order_acquire) == nullptr) {
+        state_allocator alloc(allocator_);
+        auto size = layout::segment_size(segment);
+        auto fresh = std::allocator_traits<state_allocator>::allocate(alloc, size);
+        for (size_type i = 0; i < size; i++) {
+            std::allocator_traits<state_allocator>::construct(alloc, std::addressof(*(fresh + i)), slot_claimed);
+        }
+        state_pointer expected = nullptr;
+        if (!states_[segment].compare_exchange_strong(expected, fresh, std::memory_order_acq_rel, std::memory_order_acquire)) {
+            std::allocator_traits<state_allocator>::deallocate(alloc, fresh, size);
+        }
+    }
+
+    if (segments_[segment].load(std::memory_order_acquire) != nullptr) {
+        return;
+    }
+
+    pointer expected = nullptr;
+    auto fresh = std::allocator_traits<Allocator>::allocate(allocator_, layout::segment_size(segment));
+    if (!segments_[segment].compare_exchange_strong(expected, fresh, std::memory_order_acq_rel, std::memory_order_acquire)) {
+        std::allocator_traits<Allocator>::deallocate(allocator_, fresh, layout::segment_size(segment));
+    }
+}
+
+//Claims n consecutive slots and returns the first. Their segments are installed before the
+//size is bumped, so a throwing allocation leaves nothing claimed.
+template<class T, class Allocator, std::size_t FirstSegment>
+typename concurrent_vector<T, Allocator, FirstSegment>::size_type concurrent_vector<T, Allocator, FirstSegment>::claim(size_type n)
+{
+    auto first = size_.load(std::memory_order_acquire);
+    while (true) {
+        if (n > std::numeric_limits<size_type>::max() - FirstSegment - first) {
+            throw std::length_error("concurrent_vector is full");
+        }
+        if (n != 0) {
+            for (auto i = layout::segment_of(first), last = layout::segment_of(first + n - 1); i <= last; i++) {
+                install(i);
+            }
+        }
+        if (size_.compare_exchange_weak(first, first + n, std::memory_order_acq_rel, std::memory_order_acquire)) {
+            return first;
+        }
+    }
+}
+
+template<class T, class Allocator, std::size_t FirstSegment>
+void concurrent_vector<T, Allocator, FirstSegment>::mark_failed(size_type first, size_type last) noexcept
+{
+    for (auto index = first; index != last; index++) {
+        state(index).store(slot_failed, std::memory_order_release);
+    }
+}
+
+template<class T, class Allocator, std::size_t FirstSegment>
+template<class... Args>
+void concurrent_vector<T, Allocator, FirstSegment>::construct(size_type index, Args&&... args)
+{
+    try {
+        std::allocator_traits<Allocator>::construct(allocator_, std::addressof(*element(index)), std::forward<Args>(args)...);
+    } catch (...) {
+        mark_failed(index, index + 1);
+        throw;
+    }
+    state(index).store(slot_constructed, std::memory_order_release);
+}
+
+//Constructs the n claimed slots from first on; after a throw the rest are marked failed too.
+template<class T, class Allocator, std::size_t FirstSegment>
+template<class... Args>
+void concurrent_vector<T, Allocator, FirstSegment>::construct_n(size_type first, size_type n, const Args&... args)
+{
+    auto index = first;
+    try {
+        for (; index != first + n; index++) {
+            construct(index, args...);
+        }
+    } catch (...) {
+        //construct already marked the slot that threw
+        mark_failed(index + 1, first + n);
+        throw;
+    }
+}
+
+} //namespace atl
@@ -0,0 +1,515 @@
+#pragma once
+
+#include <memory>
+#include <utility>
+#include <iterator>
+#include <stdexcept>
+#include <algorithm>
+#include <functional>
+#include <type_traits>
+#include <initializer_list>
+#include "vector.h"
+#include "flat_support.h"
+
+namespace atl {
+
+//Random-access iterator over a flat_map. Keys and values live in separate containers, so it
+//yields pairs of references rather than references to stored pairs.
+template <class Map, bool is_const>
+class FlatMapIterator
+{
+    using map_pointer = typename std::conditional<is_const, const Map*, Map*>::type;
+    using mapped_type = typename Map::mapped_type;
+
+public:
+    using size_type         = std::size_t;
+    using difference_type   = std::ptrdiff_t;
+    using value_type        = typename Map::value_type;
+    using reference         = std::pair<const typename Map::key_type&,
+                                        typename std::conditional<is_const, const mapped_type&, mapped_type&>::type>;
+    using iterator_category = std::random_access_iterator_tag;
+
+    //operator-> needs an address, so the pair of references is kept alive in a proxy
+    struct pointer
+    {
+        reference ref;
+        reference* operator->() { return std::addressof(ref); }
+    };
+
+    FlatMapIterator() : map_(nullptr), pos_(0) {}
+    FlatMapIterator(map_pointer map, difference_type pos) : map_(map), pos_(pos) {}
+
+    //implicit cast
+    operator FlatMapIterator<Map, true>() const { return FlatMapIterator<Map, true>(map_, pos_); }
+
+    reference operator*() const { return reference(map_->keys_[pos_], map_->values_[pos_]); }
+    pointer operator->() const { return pointer{**this}; }
+    reference operator[](difference_type n) const { return *(*this + n); }
+
+    FlatMapIterator& operator++() { ++pos_; return *this; }
+    FlatMapIterator operator++(int) { auto tmp = *this; ++pos_; return tmp; }
+    FlatMapIterator& operator--() { --pos_; return *this; }
+    FlatMapIterator operator--(int) { auto tmp = *this; --pos_; return tmp; }
+
+    FlatMapIterator& operator+=(difference_type n) { pos_ += n; return *this; }
+    FlatMapIterator& operator-=(difference_type n) { pos_ -= n; return *this; }
+
+    friend FlatMapIterator operator+(FlatMapIterator it, difference_type n) { return it += n; }
+    friend FlatMapIterator operator+(difference_type n, FlatMapIterator it) { return it += n; }
+    friend FlatMapIterator operator-(FlatMapIterator it, difference_type n) { return it -= n; }
+    friend difference_type operator-(const FlatMapIterator& lhs, const FlatMapIterator& rhs) { return lhs.pos_ - rhs.pos_; }
+
+    friend bool operator==(const FlatMapIterator& lhs, const FlatMapIterator& rhs) { return lhs.pos_ == rhs.pos_; }
+    friend bool operator!=(const FlatMapIterator& lhs, const FlatMapIterator& rhs) { return lhs.pos_ != rhs.pos_; }
+    friend bool operator<(const FlatMapIterator& lhs, const FlatMapIterator& rhs)  { return lhs.pos_ < rhs.pos_; }
+    friend bool operator>(const FlatMapIterator& lhs, const FlatMapIterator& rhs)  { return lhs.pos_ > rhs.pos_; }
+    friend bool operator<=(const FlatMapIterator& lhs, const FlatMapIterator& rhs) { return lhs.pos_ <= rhs.pos_; }
+    friend bool operator>=(const FlatMapIterator& lhs, const FlatMapIterator& rhs) { return lhs.pos_ >= rhs.pos_; }
+
+    difference_type index() const noexcept { return pos_; }
+
+private:
+    map_pointer map_;
+    difference_type pos_;
+};
+
+//Sorted map with keys and mapped values in two parallel contiguous containers, so a lookup
+//only touches the keys. Range inserts and the range constructors sort the new entries once
+//(the first of several equivalent keys wins) and merge them in a single pass.
+template <class Key, class T, class Compare = std::less<Key>,
+          class KeyContainer = atl::vector<Key>, class MappedContainer = atl::vector<T>>
+class flat_map {
+public:
+    // types:
+    using key_type               = Key;
+    using mapped_type            = T;
+    using value_type             = std::pair<Key, T>;
+    using key_compare            = Compare;
+    using size_type              = std::size_t;
+    using difference_type        = std::ptrdiff_t;
+    using key_container_type     = KeyContainer;
+    using mapped_container_type  = MappedContainer;
+    using iterator               = FlatMapIterator<flat_map, false>;
+    using const_iterator         = FlatMapIterator<flat_map, true>;
+    using reverse_iterator       = std::reverse_iterator<iterator>;
+    using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+    using reference              = std::pair<const Key&, T&>;
+    using const_reference        = std::pair<const Key&, const T&>;
+
+    struct containers
+    {
+        key_container_type keys;
+        mapped_container_type values;
+    };
+
+    // construct/copy/destroy:
+    flat_map() : flat_map(Compare()) {}
+    explicit flat_map(const Compare& comp) : keys_(), values_(), compare_(comp) {}
+    flat_map(key_container_type keys, mapped_container_type values, const Compare& comp = Compare());
+    flat_map(sorted_unique_t, key_container_type keys, mapped_container_type values, const Compare& comp = Compare());
+
+    template <class InputIterator, class = typename std::iterator_traits<InputIterator>::iterator_category>
+    flat_map(InputIterator first, InputIterator last, const Compare& comp = Compare());
+
+    flat_map(std::initializer_list<value_type> ilist, const Compare& comp = Compare()) : flat_map(ilist.begin(), ilist.end(), comp) {}
+
+    // iterators:
+    iterator                begin() noexcept         { return iterator(this, 0); }
+    const_iterator          begin() const noexcept   { return const_iterator(this, 0); }
+    iterator                end() noexcept           { return iterator(this, size()); }
+    const_iterator          end() const noexcept     { return const_iterator(this, size()); }
+    const_iterator          cbegin() const noexcept  { return begin(); }
+    const_iterator          cend() const noexcept    { return end(); }
+    reverse_iterator        rbegin() noexcept        { return reverse_iterator(end()); }
+    const_reverse_iterator  rbegin() const noexcept  { return const_reverse_iterator(end()); }
+    reverse_iterator        rend() noexcept          { return reverse_iterator(begin()); }
+    const_reverse_iterator  rend() const noexcept    { return const_reverse_iterator(begin()); }
+
+    // capacity:
+    bool      empty() const noexcept    { return keys_.empty(); }
+    size_type size() const noexcept     { return keys_.size(); }
+    size_type max_size() const noexcept { return std::min<size_type>(keys_.max_size(), values_.max_size()); }
+    void      reserve(size_type capacity) { keys_.reserve(capacity); values_.reserve(capacity); }
+
+    // element access:
+    mapped_type&       operator[](const key_type& key) { return try_emplace(key).first->second; }
+    mapped_type&       operator[](key_type&& key)      { return try_emplace(std::move(key)).first->second; }
+    mapped_type&       at(const key_type& key);
+    const mapped_type& at(const key_type& key) const;
+
+    const key_container_type&    keys() const noexcept   { return keys_; }
+    const mapped_container_type& values() const noexcept { return values_; }
+
+    // modifiers:
+    template <class... Args> std::pair<iterator, bool> try_emplace(const key_type& key, Args&&... args);
+    template <class... Args> std::pair<iterator, bool> try_emplace(key_type&& key, Args&&... args);
+    template <class M> std::pair<iterator, bool> insert_or_assign(const key_type& key, M&& value);
+    template <class M> std::pair<iterator, bool> insert_or_assign(key_type&& key, M&& value);
+    std::pair<iterator, bool> insert(const value_type& value) { return try_emplace(value.first, value.second); }
+    std::pair<iterator, bool> insert(value_type&& value)      { return try_emplace(std::move(value.first), std::move(value.second)); }
+
+    template <class InputIterator, class = typename std::iterator_traits<InputIterator>::iterator_category>
+    void insert(InputIterator first, InputIterator last);
+    template <class InputIterator, class = typename std::iterator_traits<InputIterator>::iterator_category>
+    void insert(sorted_unique_t, InputIterator first, InputIterator last);
+    void insert(std::initializer_list<value_type> ilist) { insert(ilist.begin(), ilist.end()); }
+
+    iterator   erase(const_iterator position) { return erase(position, position + 1); }
+    iterator   erase(const_iterator first, const_iterator last);
+    size_type  erase(const key_type& key);
+    void       swap(flat_map& other) noexcept;
+    void       clear() noexcept { keys_.clear(); values_.clear(); }
+
+    containers extract() &&;
+    void       replace(key_container_type&& keys, mapped_container_type&& values);
+
+    // observers:
+    key_compare key_comp() const { return compare_; }
+
+    // lookup:
+    iterator       find(const key_type& key)       { return begin() + (find_index(key)); }
+    const_iterator find(const key_type& key) const { return begin() + (find_index(key)); }
+    size_type      count(const key_type& key) const { return contains(key) ? 1 : 0; }
+    bool           contains(const key_type& key) const { return static_cast<size_type>(find_index(key)) != size(); }
+    iterator       lower_bound(const key_type& key)       { return begin() + lower_index(key); }
+    const_iterator lower_bound(const key_type& key) const { return begin() + lower_index(key); }
+    iterator       upper_bound(const key_type& key)       { return begin() + upper_index(key); }
+    const_iterator upper_bound(const key_type& key) const { return begin() + upper_index(key); }
+    std::pair<iterator, iterator>             equal_range(const key_type& key);
+    std::pair<const_iterator, const_iterator> equal_range(const key_type& key) const;
+
+private:
+    template <class, bool> friend class FlatMapIterator;
+
+    key_container_type keys_;
+    mapped_container_type values_;
+    Compare compare_;
+
+    difference_type lower_index(const key_type& key) const;
+    difference_type upper_index(const key_type& key) const;
+    difference_type find_index(const key_type& key) const;
+    template <class K, class... Args> std::pair<iterator, bool> emplace_unique(K&& key, Args&&... args);
+    void sort_and_merge(atl::vector<value_type>&& incoming);
+    void merge_unique(atl::vector<value_type>&& incoming);
+};
+
+template<class Key, class T, class Compare, class KeyContainer, class MappedContainer>
+flat_map<Key, T, Compare, KeyContainer, MappedContainer>::flat_map(key_container_type keys, mapped_container_type values, const Compare& comp)
+        : keys_(), values_(), compare_(comp)
+{
+    if (keys.size() != values.size()) {
+        throw std::invalid_argument("flat_map needs one value per key");
+    }
+
+    atl::vector<value_type> incoming;
+    incoming.reserve(keys.size());
+    for (size_type i = 0; i < keys.size(); i++) {
+        incoming.emplace_back(std::move(keys[i]), std::move(values[i]));
+    }
+    sort_and_merge(std::move(incoming));
+}
+
+template<class Key, class T, class Compare, class KeyContainer, class MappedContainer>
+flat_map<Key, T, Compare, KeyContainer, MappedContainer>::flat_map(sorted_unique_t, key_container_type keys, mapped_container_type values, const Compare& comp)
+        : keys_(std::move(keys)), values_(std::move(values)), compare_(comp)
+{
+    if (keys_.size() != values_.size()) {
+        throw std::invalid_argument("flat_map needs one value per key");
+    }
+}
+
+template<class Key, class T, class Compare, class KeyContainer, class MappedContainer>
+template<class InputIterator, class>
+flat_map<Key, T, Compare, KeyContainer, MappedContainer>::flat_map(InputIterator first, InputIterator last, const Compare& comp)
+        : keys_(), values_(), compare_(comp)
+{
+    insert(first, last);
+}
+
+template<class Key, class T, class Compare, class KeyContainer, class MappedContainer>
+typename flat_map<Key, T, Compare, KeyContainer, MappedContainer>::mapped_type&
+flat_map<Key, T, Compare, KeyContainer, MappedContainer>::at(const key_type& key)
+{
+    auto index = find_index(key);
+    if (static_cast<size_type>(index) == size()) {
+        throw std::out_of_range("Key not found");
+    }
+    return values_[index];
+}
+
+template<class Key, class T, class Compare, class KeyContainer, class MappedContainer>
+const typename flat_map<Key, T, Compare, KeyContainer, MappedContainer>::mapped_type&
+flat_map<Key, T, Compare, KeyContainer, MappedContainer>::at(const key_type& key) const
+{
+    auto index = find_index(key);
+    if (static_cast<size_type>(index) == size()) {
+        throw std::out_of_range("Key not found");
+    }
+    return values_[index];
+}
+
+template<class Key, class T, class Compare, class KeyContainer, class MappedContainer>
+template<class... Args>
+std::pair<typename flat_map<Key, T, Compare, KeyContainer, MappedContainer>::iterator, bool>
+flat_map<Key, T, Compare, KeyContainer, MappedContainer>::try_emplace(const key_type& key, Args&&... args)
+{
+    return emplace_unique(key, std::forward<Args>(args)...);
+}
+
+template<class Key, class T, class Compare, class KeyContainer, class MappedContainer>
+template<class... Args>
+std::pair<typename flat_map<Key, T, Compare, KeyContainer, MappedContainer>::iterator, bool>
+flat_map<Key, T, Compare, KeyContainer, MappedContainer>::try_emplace(key_type&& key, Args&&... args)
+{
+    return emplace_unique(std::move(key), std::forward<Args>(args)...);
+}
+
+template<class Key, class T, class Compare, class KeyContainer, class MappedContainer>
+template<class M>
+std::pair<typename flat_map<Key, T, Compare, KeyContainer, MappedContainer>::iterator, bool>
+flat_map<Key, T, Compare, KeyContainer, MappedContainer>::insert_or_assign(const key_type& key, M&& value)
+{
+    auto result = emplace_unique(key, std::forward<M>(value));
+    if (!result.second) {
+        values_[result.first.index()] = std::forward<M>(value);
+    }
+    return result;
+}
+
+template<class Key, class T, class Compare, class KeyContainer, class MappedContainer>
+template<class M>
+std::pair<typename flat_map<Key, T, Compare, KeyContainer, MappedContainer>::iterator, bool>
+flat_map<Key, T, Compare, KeyContainer, MappedContainer>::insert_or_assign(key_type&& key, M&& value)
+{
+    auto result = emplace_unique(std::move(key), std::forward<M>(value));
+    if (!result.second) {
+        values_[result.first.index()] = std::forward<M>(value);
+    }
+    return result;
+}
+
+template<class Key, class T, class Compare, class KeyContainer, class MappedContainer>
+template<class InputIterator, class>
+void flat_map<Key, T, Compare, KeyContainer, MappedContainer>::insert(InputIterator first, InputIterator last)
+{
+    sort_and_merge(atl::vector<value_type>(first, last));
+}
+
+template<class Key, class T, class Compare, class KeyContainer, class MappedContainer>
+template<class InputIterator, class>
+void flat_map<Key, T, Compare, KeyContainer, MappedContainer>::insert(sorted_unique_t, InputIterator first, InputIterator last)
+{
+    merge_unique(atl::vector<value_type>(first, last));
+}
+
+template<class Key, class T, class Compare, class KeyContainer, class MappedContainer>
+typename flat_map<Key, T, Compare, KeyContainer, MappedContainer>::iterator
+flat_map<Key, T, Compare, KeyContainer, MappedContainer>::erase(const_iterator first, const_iterator last)
+{
+    keys_.erase(keys_.begin() + first.index(), keys_.begin() + last.index());
+    values_.erase(values_.begin() + first.index(), values_.begin() + last.index());
+    return begin() + first.index();
+}
+
+template<class Key, class T, class Compare, class KeyContainer, class MappedContainer>
+typename flat_map<Key, T, Compare, KeyContainer, MappedContainer>::size_type
+flat_map<Key, T, Compare, KeyContainer, MappedContainer>::erase(const key_type& key)
+{
+    auto index = find_index(key);
+    if (static_cast<size_type>(index) == size()) {
+        return 0;
+    }
+    erase(begin() + index);
+    return 1;
+}
+
+template<class Key, class T, class Compare, class KeyContainer, class MappedContainer>
+void flat_map<Key, T, Compare, KeyContainer, MappedContainer>::swap(flat_map& other) noexcept
+{
+    using std::swap;
+    swap(keys_, other.keys_);
+    swap(values_, other.values_);
+    swap(compare_, other.compare_);
+}
+
+template<class Key, class T, class Compare, class KeyContainer, class MappedContainer>
+typename flat_map<Key, T, Compare, KeyContainer, MappedContainer>::containers
+flat_map<Key, T, Compare, KeyContainer, MappedContainer>::extract() &&
+{
+    return containers{std::move(keys_), std::move(values_)};
+}
+
+template<class Key, class T, class Compare, class KeyContainer, class MappedContainer>
+void flat_map<Key, T, Compare, KeyContainer, MappedContainer>::replace(key_container_type&& keys, mapped_container_type&& values)
+{
+    if (keys.size() != values.size()) {
+        throw std::invalid_argument("flat_map needs one value per key");
+    }
+    keys_ = std::move(keys);
+    values_ = std::move(values);
+}
+
+template<class Key, class T, class Compare, class KeyContainer, class MappedContainer>
+typename flat_map<Key, T, Compare, KeyContainer, MappedContainer>::difference_type
+flat_map<Key, T, Compare, KeyContainer, MappedContainer>::lower_index(const key_type& key) const
+{
+    auto first = keys_.data();
+    return branchless_lower_bound(first, first + keys_.size(), key, compare_) - first;
+}
+
+template<class Key, class T, class Compare, class KeyContainer, class MappedContainer>
+typename flat_map<Key, T, Compare, KeyContainer, MappedContainer>::difference_type
+flat_map<Key, T, Compare, KeyContainer, MappedContainer>::upper_index(const key_type& key) const
+{
+    auto first = keys_.data();
+    return branchless_upper_bound(first, first + keys_.size(), key, compare_) - first;
+}
+
+template<class Key, class T, class Compare, class KeyContainer, class MappedContainer>
+std::pair<typename flat_map<Key, T, Compare, KeyContainer, MappedContainer>::iterator,
+          typename flat_map<Key, T, Compare, KeyContainer, MappedContainer>::iterator>
+flat_map<Key, T, Compare, KeyContainer, MappedContainer>::equal_range(const key_type& key)
+{
+    auto index = lower_index(key);
+    auto first = begin() + index;
+    if (static_cast<size_type>(index) != size() && !compare_(key, keys_[index])) {
+        return {first, first + 1};
+    }
+    return {first, first};
+}
+
+template<class Key, class T, class Compare, class KeyContainer, class MappedContainer>
+std::pair<typename flat_map<Key, T, Compare, KeyContainer, MappedContainer>::const_iterator,
+          typename flat_map<Key, T, Compare, KeyContainer, MappedContainer>::const_iterator>
+flat_map<Key, T, Compare, KeyContainer, MappedContainer>::equal_range(const key_type& key) const
+{
+    auto index = lower_index(key);
+    auto first = begin() + index;
+    if (static_cast<size_type>(index) != size() && !compare_(key, keys_[index])) {
+        return {first, first + 1};
+    }
+    return {first, first};
+}
+
+//Index of key, or size() if absent.
+template<class Key, class T, class Compare, class KeyContainer, class MappedContainer>
+typename flat_map<Key, T, Compare, KeyContainer, MappedContainer>::difference_type
+flat_map<Key, T, Compare, KeyContainer, MappedContainer>::find_index(const key_type& key) const
+{
+    auto index = lower_index(key);
+    if (static_cast<size_type>(index) != size() && !compare_(key, keys_[index])) {
+        return index;
+    }
+    return size();
+}
+
+template<class Key, class T, class Compare, class KeyContainer, class MappedContainer>
+template<class K, class... Args>
+std::pair<typename flat_map<Key, T, Compare, KeyContainer, MappedContainer>::iterator, bool>
+flat_map<Key, T, Compare, KeyContainer, MappedContainer>::emplace_unique(K&& key, Args&&... args)
+{
+    auto index = lower_index(key);
+    if (static_cast<size_type>(index) != size() && !compare_(key, keys_[index])) {
+        return {begin() + index, false};
+    }
+
+    values_.emplace(values_.begin() + index, std::forward<Args>(args)...);
+    try {
+        keys_.insert(keys_.begin() + index, std::forward<K>(key));
+    } catch (...) {
+        values_.erase(values_.begin() + index);
+        throw;
+    }
+    return {begin() + index, true};
+}
+
+template<class Key, class T, class Compare, class KeyContainer, class MappedContainer>
+void flat_map<Key, T, Compare, KeyContainer, MappedContainer>::sort_and_merge(atl::vector<value_type>&& incoming)
+{
+    auto by_key = [this](const value_type& lhs, const value_type& rhs) { return compare_(lhs.first, rhs.first); };
+    detail::sort_unique(incoming, by_key);
+    merge_unique(std::move(incoming));
+}
+
+//Merges entries sorted by unique key in one pass; keys already present keep their values.
+template<class Key, class T, class Compare, class KeyContainer, class MappedContainer>
+void flat_map<Key, T, Compare, KeyContainer, MappedContainer>::merge_unique(atl::vector<value_type>&& incoming)
+{
+    if (incoming.empty()) {
+        return;
+    }
+
+    //appending past the current maximum is the common bulk-load case and needs no merge
+    if (keys_.empty() || compare_(keys_.back(), incoming.front().first)) {
+        reserve(size() + incoming.size());
+        for (auto& entry : incoming) {
+            keys_.push_back(std::move(entry.first));
+            try {
+                values_.push_back(std::move(entry.second));
+            } catch (...) {
+                //keys_ and values_ must stay the same length
+                keys_.pop_back();
+                throw;
+            }
+        }
+        return;
+    }
+
+    key_container_type keys;
+    mapped_container_type values;
+    keys.reserve(keys_.size() + incoming.size());
+    values.reserve(keys_.size() + incoming.size());
+
+    size_type lhs = 0;
+    auto rhs = incoming.begin();
+    while (lhs != keys_.size() && rhs != incoming.end()) {
+        if (compare_(rhs->first, keys_[lhs])) {
+            keys.push_back(std::move(rhs->first));
+            values.push_back(std::move(rhs->second));
+            ++rhs;
+        } else {
+            if (!compare_(keys_[lhs], rhs->first)) {
+                ++rhs;
+            }
+            keys.push_back(std::move(keys_[lhs]));
+            values.push_back(std::move(values_[lhs]));
+            ++lhs;
+        }
+    }
+    for (; lhs != keys_.size(); ++lhs) {
+        keys.push_back(std::move(keys_[lhs]));
+        values.push_back(std::move(values_[lhs]));
+    }
+    for (; rhs != incoming.end(); ++rhs) {
+        keys.push_back(std::move(rhs->first));
+        values.push_back(std::move(rhs->second));
+    }
+
+    keys_ = std::move(keys);
+    values_ = std::move(values);
+}
+
+template <class Key, class T, class Compare, class KeyContainer, class MappedContainer>
+bool operator==(const flat_map<Key, T, Compare, KeyContainer, MappedContainer>& lhs,
+                const flat_map<Key, T, Compare, KeyContainer, MappedContainer>& rhs)
+{
+    return lhs.size() == rhs.size() &&
+           std::equal(lhs.keys().begin(), lhs.keys().end(), rhs.keys().begin()) &&
+           std::equal(lhs.values().begin(), lhs.values().end(), rhs.values().begin());
+}
+
+template <class Key, class T, class Compare, class KeyContainer, class MappedContainer>
+bool operator!=(const flat_map<Key, T, Compare, KeyContainer, MappedContainer>& lhs,
+                const flat_map<Key, T, Compare, KeyContainer, MappedContainer>& rhs)
+{
+    return !(lhs == rhs);
+}
+
+template <class Key, class T, class Compare, class KeyContainer, class MappedContainer>
+void swap(flat_map<Key, T, Compare, KeyContainer, MappedContainer>& lhs,
+          flat_map<Key, T, Compare, KeyContainer, MappedContainer>& rhs) noexcept
+{
+    lhs.swap(rhs);
+}
+
+} //namespace atl
@@ -0,0 +1,255 @@
+#pragma once
+
+#include <utility>
+#include <iterator>
+#include <algorithm>
+#include <functional>
+#include <initializer_list>
+#include "vector.h"
+#include "flat_support.h"
+
+namespace atl {
+
+//Sorted set stored in one contiguous container. Lookups are branchless binary searches over
+//the keys; single inserts and erases shift the tail, while range inserts sort the new keys
+//once and merge them in a single pass.
+template <class Key, class Compare = std::less<Key>, class KeyContainer = atl::vector<Key>>
+class flat_set {
+public:
+    // types:
+    using key_type               = Key;
+    using value_type             = Key;
+    using key_compare            = Compare;
+    using value_compare          = Compare;
+    using reference              = value_type&;
+    using const_reference        = const value_type&;
+    using size_type              = typename KeyContainer::size_type;
+    using difference_type        = typename KeyContainer::difference_type;
+    using container_type         = KeyContainer;
+    using iterator               = typename KeyContainer::const_iterator;
+    using const_iterator         = typename KeyContainer::const_iterator;
+    using reverse_iterator       = std::reverse_iterator<iterator>;
+    using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+    // construct/copy/destroy:
+    flat_set() : flat_set(Compare()) {}
+    explicit flat_set(const Compare& comp) : keys_(), compare_(comp) {}
+    explicit flat_set(container_type keys, const Compare& comp = Compare());
+    flat_set(sorted_unique_t, container_type keys, const Compare& comp = Compare()) : keys_(std::move(keys)), compare_(comp) {}
+
+    template <class InputIterator, class = typename std::iterator_traits<InputIterator>::iterator_category>
+    flat_set(InputIterator first, InputIterator last, const Compare& comp = Compare());
+
+    flat_set(std::initializer_list<Key> ilist, const Compare& comp = Compare()) : flat_set(ilist.begin(), ilist.end(), comp) {}
+
+    // iterators:
+    const_iterator          begin() const noexcept   { return keys_.begin(); }
+    const_iterator          end() const noexcept     { return keys_.end(); }
+    const_iterator          cbegin() const noexcept  { return keys_.cbegin(); }
+    const_iterator          cend() const noexcept    { return keys_.cend(); }
+    const_reverse_iterator  rbegin() const noexcept  { return const_reverse_iterator(end()); }
+    const_reverse_iterator  rend() const noexcept    { return const_reverse_iterator(begin()); }
+
+    // capacity:
+    bool      empty() const noexcept    { return keys_.empty(); }
+    size_type size() const noexcept     { return keys_.size(); }
+    size_type max_size() const noexcept { return keys_.max_size(); }
+    void      reserve(size_type capacity) { keys_.reserve(capacity); }
+
+    // modifiers:
+    template <class... Args> std::pair<iterator, bool> emplace(Args&&... args);
+    std::pair<iterator, bool> insert(const value_type& key) { return insert_unique(key); }
+    std::pair<iterator, bool> insert(value_type&& key)      { return insert_unique(std::move(key)); }
+
+    template <class InputIterator, class = typename std::iterator_traits<InputIterator>::iterator_category>
+    void insert(InputIterator first, InputIterator last);
+    template <class InputIterator, class = typename std::iterator_traits<InputIterator>::iterator_category>
+    void insert(sorted_unique_t, InputIterator first, InputIterator last);
+    void insert(std::initializer_list<Key> ilist) { insert(ilist.begin(), ilist.end()); }
+
+    iterator  erase(const_iterator position) { return keys_.erase(position); }
+    iterator  erase(const_iterator first, const_iterator last) { return keys_.erase(first, last); }
+    size_type erase(const key_type& key);
+    void      swap(flat_set& other) noexcept;
+    void      clear() noexcept { keys_.clear(); }
+
+    container_type extract() && { return std::move(keys_); }
+    void           replace(container_type&& keys) { keys_ = std::move(keys); }
+
+    // observers:
+    key_compare   key_comp() const   { return compare_; }
+    value_compare value_comp() const { return compare_; }
+
+    // lookup:
+    const_iterator find(const key_type& key) const;
+    size_type      count(const key_type& key) const { return contains(key) ? 1 : 0; }
+    bool           contains(const key_type& key) const { return find(key) != end(); }
+    const_iterator lower_bound(const key_type& key) const;
+    const_iterator upper_bound(const key_type& key) const;
+    std::pair<const_iterator, const_iterator> equal_range(const key_type& key) const;
+
+private:
+    container_type keys_;
+    Compare compare_;
+
+    template <class K> std::pair<iterator, bool> insert_unique(K&& key);
+    void merge_unique(container_type&& incoming);
+};
+
+template<class Key, class Compare, class KeyContainer>
+flat_set<Key, Compare, KeyContainer>::flat_set(container_type keys, const Compare& comp)
+        : keys_(std::move(keys)), compare_(comp)
+{
+    detail::sort_unique(keys_, compare_);
+}
+
+template<class Key, class Compare, class KeyContainer>
+template<class InputIterator, class>
+flat_set<Key, Compare, KeyContainer>::flat_set(InputIterator first, InputIterator last, const Compare& comp)
+        : keys_(first, last), compare_(comp)
+{
+    detail::sort_unique(keys_, compare_);
+}
+
+template<class Key, class Compare, class KeyContainer>
+template<class... Args>
+std::pair<typename flat_set<Key, Compare, KeyContainer>::iterator, bool> flat_set<Key, Compare, KeyContainer>::emplace(Args&&... args)
+{
+    return insert_unique(Key(std::forward<Args>(args)...));
+}
+
+template<class Key, class Compare, class KeyContainer>
+template<class K>
+std::pair<typename flat_set<Key, Compare, KeyContainer>::iterator, bool> flat_set<Key, Compare, KeyContainer>::insert_unique(K&& key)
+{
+    auto position = lower_bound(key);
+    if (position != end() && !compare_(key, *position)) {
+        return {position, false};
+    }
+    return {keys_.insert(position, std::forward<K>(key)), true};
+}
+
+template<class Key, class Compare, class KeyContainer>
+template<class InputIterator, class>
+void flat_set<Key, Compare, KeyContainer>::insert(InputIterator first, InputIterator last)
+{
+    container_type incoming(first, last);
+    detail::sort_unique(incoming, compare_);
+    merge_unique(std::move(incoming));
+}
+
+template<class Key, class Compare, class KeyContainer>
+template<class InputIterator, class>
+void flat_set<Key, Compare, KeyContainer>::insert(sorted_unique_t, InputIterator first, InputIterator last)
+{
+    merge_unique(container_type(first, last));
+}
+
+template<class Key, class Compare, class KeyContainer>
+typename flat_set<Key, Compare, KeyContainer>::size_type flat_set<Key, Compare, KeyContainer>::erase(const key_type& key)
+{
+    auto position = find(key);
+    if (position == end()) {
+        return 0;
+    }
+    keys_.erase(position);
+    return 1;
+}
+
+template<class Key, class Compare, class KeyContainer>
+void flat_set<Key, Compare, KeyContainer>::swap(flat_set& other) noexcept
+{
+    using std::swap;
+    swap(keys_, other.keys_);
+    swap(compare_, other.compare_);
+}
+
+template<class Key, class Compare, class KeyContainer>
+typename flat_set<Key, Compare, KeyContainer>::const_iterator flat_set<Key, Compare, KeyContainer>::find(const key_type& key) const
+{
+    auto position = lower_bound(key);
+    if (position != end() && !compare_(key, *position)) {
+        return position;
+    }
+    return end();
+}
+
+template<class Key, class Compare, class KeyContainer>
+typename flat_set<Key, Compare, KeyContainer>::const_iterator flat_set<Key, Compare, KeyContainer>::lower_bound(const key_type& key) const
+{
+    auto first = keys_.data();
+    return begin() + (branchless_lower_bound(first, first + keys_.size(), key, compare_) - first);
+}
+
+template<class Key, class Compare, class KeyContainer>
+typename flat_set<Key, Compare, KeyContainer>::const_iterator flat_set<Key, Compare, KeyContainer>::upper_bound(const key_type& key) const
+{
+    auto first = keys_.data();
+    return begin() + (branchless_upper_bound(first, first + keys_.size(), key, compare_) - first);
+}
+
+template<class Key, class Compare, class KeyContainer>
+std::pair<typename flat_set<Key, Compare, KeyContainer>::const_iterator, typename flat_set<Key, Compare, KeyContainer>::const_iterator>
+flat_set<Key, Compare, KeyContainer>::equal_range(const key_type& key) const
+{
+    auto first = lower_bound(key);
+    if (first != end() && !compare_(key, *first)) {
+        return {first, first + 1};
+    }
+    return {first, first};
+}
+
+//Merges sorted, duplicate-free keys in one pass; keys already present win over incoming ones.
+template<class Key, class Compare, class KeyContainer>
+void flat_set<Key, Compare, KeyContainer>::merge_unique(container_type&& incoming)
+{
+    if (incoming.empty()) {
+        return;
+    }
+
+    //appending past the current maximum is the common bulk-load case and needs no merge
+    if (keys_.empty() || compare_(keys_.back(), incoming.front())) {
+        keys_.insert(keys_.end(), std::make_move_iterator(incoming.begin()), std::make_move_iterator(incoming.end()));
+        return;
+    }
+
+    container_type merged;
+    merged.reserve(keys_.size() + incoming.size());
+
+    auto lhs = keys_.begin();
+    auto rhs = incoming.begin();
+    while (lhs != keys_.end() && rhs != incoming.end()) {
+        if (compare_(*rhs, *lhs)) {
+            merged.push_back(std::move(*rhs++));
+        } else {
+            if (!compare_(*lhs, *rhs)) {
+                ++rhs;
+            }
+            merged.push_back(std::move(*lhs++));
+        }
+    }
+    merged.insert(merged.end(), std::make_move_iterator(lhs), std::make_move_iterator(keys_.end()));
+    merged.insert(merged.end(), std::make_move_iterator(rhs), std::make_move_iterator(incoming.end()));
+
+    keys_ = std::move(merged);
+}
+
+template <class Key, class Compare, class KeyContainer>
+bool operator==(const flat_set<Key, Compare, KeyContainer>& lhs, const flat_set<Key, Compare, KeyContainer>& rhs)
+{
+    return lhs.size() == rhs.size() && std::equal(lhs.begin(), lhs.end(), rhs.begin());
+}
+
+template <class Key, class Compare, class KeyContainer>
+bool operator!=(const flat_set<Key, Compare, KeyContainer>& lhs, const flat_set<Key, Compare, KeyContainer>& rhs)
+{
+    return !(lhs == rhs);
+}
+
+template <class Key, class Compare, class KeyContainer>
+void swap(flat_set<Key, Compare, KeyContainer>& lhs, flat_set<Key, Compare, KeyContainer>& rhs) noexcept
+{
+    lhs.swap(rhs);
+}
+
+} //namespace atl
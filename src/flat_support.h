@@ -0,0 +1,61 @@
+#pragma once
+
+#include <cstddef>
+#include <iterator>
+#include <algorithm>
+
+namespace atl {
+
+//Tag for flat_set/flat_map constructors and inserts whose input is already sorted and free of duplicates.
+struct sorted_unique_t { explicit sorted_unique_t() = default; };
+inline constexpr sorted_unique_t sorted_unique{};
+
+//lower_bound over a contiguous array without a data-dependent branch: the loop runs
+//ceil(log2(n)) times whatever the data, and the step is a conditional move, so lookups
+//in large tables do not pay for mispredicted comparisons.
+template <class T, class K, class Compare>
+const T* branchless_lower_bound(const T* first, const T* last, const K& key, Compare& comp)
+{
+    auto n = static_cast<std::size_t>(last - first);
+    if (n == 0) {
+        return first;
+    }
+
+    while (n > 1) {
+        auto half = n / 2;
+        first = comp(first[half], key) ? first + half : first;
+        n -= half;
+    }
+    return first + comp(*first, key);
+}
+
+template <class T, class K, class Compare>
+const T* branchless_upper_bound(const T* first, const T* last, const K& key, Compare& comp)
+{
+    auto n = static_cast<std::size_t>(last - first);
+    if (n == 0) {
+        return first;
+    }
+
+    while (n > 1) {
+        auto half = n / 2;
+        first = comp(key, first[half]) ? first : first + half;
+        n -= half;
+    }
+    return first + !comp(key, *first);
+}
+
+namespace detail {
+
+//Sorts a container and drops all but the first of every run of equivalent elements.
+template <class Container, class Compare>
+void sort_unique(Container& c, Compare& comp)
+{
+    std::stable_sort(c.begin(), c.end(), comp);
+    auto last = std::unique(c.begin(), c.end(), [&comp](const auto& a, const auto& b) { return !comp(a, b); });
+    c.erase(last, c.end());
+}
+
+} //namespace detail
+
+} //namespace atl
@@ -0,0 +1,519 @@
+#pragma once
+
+#include <memory>
+#include <cstddef>
+#include <utility>
+#include <iterator>
+#include <algorithm>
+#include <stdexcept>
+#include <type_traits>
+#include <initializer_list>
+#include "relocate.h"
+#include "indexed_iterator.h"
+#include "growth_policy.h"
+#include "allocator_support.h"
+
+namespace atl {
+
+//Sequence kept in one buffer with a movable gap at the edit cursor (the classic editor buffer).
+//Insertions and erasures next to the previous edit cost O(1) amortized; moving the cursor costs
+//the distance moved. linearize() closes the gap and exposes the elements as one contiguous array.
+template <class T, class Allocator = std::allocator<T>, class GrowthPolicy = default_growth_policy>
+class gap_vector {
+public:
+    // types:
+    using value_type             = T;
+    using reference              = value_type&;
+    using const_reference        = const value_type&;
+    using size_type              = std::size_t;
+    using difference_type        = std::ptrdiff_t;
+
+    using allocator_type         = Allocator;
+    using pointer                = typename std::allocator_traits<Allocator>::pointer;
+    using const_pointer          = typename std::allocator_traits<Allocator>::const_pointer;
+    using iterator               = IndexedIterator<gap_vector, false>;
+    using const_iterator         = IndexedIterator<gap_vector, true>;
+    using reverse_iterator       = std::reverse_iterator<iterator>;
+    using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+    // construct/copy/destroy:
+    explicit gap_vector(const Allocator& alloc = Allocator()) noexcept;
+    gap_vector(size_type size, const T& value, const Allocator& alloc = Allocator());
+
+    template <class InputIterator, class = typename std::iterator_traits<InputIterator>::iterator_category>
+    gap_vector(InputIterator first, InputIterator last, const Allocator& alloc = Allocator());
+
+    gap_vector(std::initializer_list<T> ilist, const Allocator& alloc = Allocator());
+    gap_vector(const gap_vector& other);
+    gap_vector(gap_vector&& other) noexcept;
+    ~gap_vector();
+
+    gap_vector& operator=(const gap_vector& rhs);
+    gap_vector& operator=(gap_vector&& rhs) noexcept(std::allocator_traits<Allocator>::propagate_on_container_move_assignment::value ||
+                                                     std::allocator_traits<Allocator>::is_always_equal::value);
+
+    allocator_type get_allocator() const noexcept { return allocator_; }
+
+    // iterators:
+    iterator                begin() noexcept         { return iterator(this, 0); }
+    const_iterator          begin() const noexcept   { return const_iterator(this, 0); }
+    iterator                end() noexcept           { return iterator(this, size()); }
+    const_iterator          end() const noexcept     { return const_iterator(this, size()); }
+    const_iterator          cbegin() const noexcept  { return begin(); }
+    const_iterator          cend() const noexcept    { return end(); }
+
+    reverse_iterator        rbegin() noexcept        { return reverse_iterator(end()); }
+    const_reverse_iterator  rbegin() const noexcept  { return const_reverse_iterator(end()); }
+    reverse_iterator        rend() noexcept          { return reverse_iterator(begin()); }
+    const_reverse_iterator  rend() const noexcept    { return const_reverse_iterator(begin()); }
+
+    // capacity:
+    size_type size() const noexcept     { return capacity_ - gap_size(); }
+    size_type capacity() const noexcept { return capacity_; }
+    bool      empty() const noexcept    { return size() == 0; }
+    void      reserve(size_type capacity);
+
+    //logical index the gap currently sits at
+    size_type gap_position() const noexcept { return gap_begin_; }
+
+    // element access:
+    reference       operator[](size_type n)       { return data_[physical(n)]; }
+    const_reference operator[](size_type n) const { return data_[physical(n)]; }
+    reference       at(size_type pos);
+    const_reference at(size_type pos) const;
+    reference       front()       { return (*this)[0]; }
+    const_reference front() const { return (*this)[0]; }
+    reference       back()        { return (*this)[size() - 1]; }
+    const_reference back() const  { return (*this)[size() - 1]; }
+
+    //moves the gap behind the last element and returns the now contiguous elements
+    pointer linearize();
+    pointer data() { return linearize(); }
+
+    // modifiers:
+    template <class... Args> reference emplace_back(Args&& ...args);
+    void push_back(const T& elem);
+    void push_back(T&& elem);
+    void pop_back();
+
+    template <class... Args> iterator emplace(const_iterator position, Args&&... args);
+    iterator insert(const_iterator position, const T& elem);
+    iterator insert(const_iterator position, T&& elem);
+    iterator insert(const_iterator position, size_type n, const T& elem);
+    template <class InputIterator, class = typename std::iterator_traits<InputIterator>::iterator_category>
+    iterator insert(const_iterator position, InputIterator first, InputIterator last);
+    iterator insert(const_iterator position, std::initializer_list<T>);
+
+    iterator erase(const_iterator position);
+    iterator erase(const_iterator first, const_iterator last);
+    void     swap(gap_vector&) noexcept;
+    void     clear() noexcept;
+
+private:
+    Allocator allocator_;
+    pointer data_;
+    size_type capacity_;
+    size_type gap_begin_;
+    size_type gap_end_;
+
+    size_type gap_size() const noexcept { return gap_end_ - gap_begin_; }
+    size_type physical(size_type index) const noexcept { return index < gap_begin_ ? index : index + gap_size(); }
+
+    void move_gap(size_type index);
+    void grow_gap(size_type needed);
+    template <class... Args> iterator emplace_at(size_type index, Args&&... args);
+    void release() noexcept;
+    void swap_storage(gap_vector& other) noexcept;
+    bool in_buffer(const T& elem) const noexcept;
+};
+
+template<class T, class Allocator, class GrowthPolicy>
+gap_vector<T, Allocator, GrowthPolicy>::gap_vector(const Allocator& alloc) noexcept
+        : allocator_(alloc),
+          data_(nullptr),
+          capacity_(0),
+          gap_begin_(0),
+          gap_end_(0) {}
+
+template<class T, class Allocator, class GrowthPolicy>
+gap_vector<T, Allocator, GrowthPolicy>::gap_vector(size_type size, const T& value, const Allocator& alloc)
+        : gap_vector(alloc)
+{
+    insert(end(), size, value);
+}
+
+template<class T, class Allocator, class GrowthPolicy>
+template<class InputIterator, class>
+gap_vector<T, Allocator, GrowthPolicy>::gap_vector(InputIterator first, InputIterator last, const Allocator& alloc)
+        : gap_vector(alloc)
+{
+    insert(end(), first, last);
+}
+
+template<class T, class Allocator, class GrowthPolicy>
+gap_vector<T, Allocator, GrowthPolicy>::gap_vector(std::initializer_list<T> ilist, const Allocator& alloc)
+        : gap_vector(alloc)
+{
+    insert(end(), ilist.begin(), ilist.end());
+}
+
+template<class T, class Allocator, class GrowthPolicy>
+gap_vector<T, Allocator, GrowthPolicy>::gap_vector(const gap_vector& other)
+        : gap_vector(std::allocator_traits<Allocator>::select_on_container_copy_construction(other.allocator_))
+{
+    insert(end(), other.begin(), other.end());
+}
+
+template<class T, class Allocator, class GrowthPolicy>
+gap_vector<T, Allocator, GrowthPolicy>::gap_vector(gap_vector&& other) noexcept
+        : gap_vector(std::move(other.allocator_))
+{
+    swap_storage(other);
+}
+
+template<class T, class Allocator, class GrowthPolicy>
+gap_vector<T, Allocator, GrowthPolicy>::~gap_vector()
+{
+    release();
+}
+
+template<class T, class Allocator, class GrowthPolicy>
+gap_vector<T, Allocator, GrowthPolicy>& gap_vector<T, Allocator, GrowthPolicy>::operator=(const gap_vector& rhs)
+{
+    if (this == &rhs) {
+        return *this;
+    }
+
+    if constexpr (std::allocator_traits<Allocator>::propagate_on_container_copy_assignment::value) {
+        if (!(allocator_ == rhs.allocator_)) {
+            release();
+        }
+        allocator_ = rhs.allocator_;
+    }
+
+    clear();
+    insert(end(), rhs.begin(), rhs.end());
+    return *this;
+}
+
+template<class T, class Allocator, class GrowthPolicy>
+gap_vector<T, Allocator, GrowthPolicy>& gap_vector<T, Allocator, GrowthPolicy>::operator=(gap_vector&& rhs)
+        noexcept(std::allocator_traits<Allocator>::propagate_on_container_move_assignment::value ||
+                 std::allocator_traits<Allocator>::is_always_equal::value)
+{
+    if (this == &rhs) {
+        return *this;
+    }
+
+    if constexpr (!std::allocator_traits<Allocator>::propagate_on_container_move_assignment::value) {
+        if (!(allocator_ == rhs.allocator_)) {
+            clear();
+            insert(end(), std::make_move_iterator(rhs.begin()), std::make_move_iterator(rhs.end()));
+            rhs.clear();
+            return *this;
+        }
+    }
+
+    release();
+    if constexpr (std::allocator_traits<Allocator>::propagate_on_container_move_assignment::value) {
+        allocator_ = std::move(rhs.allocator_);
+    }
+    swap_storage(rhs);
+    return *this;
+}
+
+template<class T, class Allocator, class GrowthPolicy>
+void gap_vector<T, Allocator, GrowthPolicy>::reserve(size_type capacity)
+{
+    if (capacity > capacity_) {
+        grow_gap(capacity - size());
+    }
+}
+
+template<class T, class Allocator, class GrowthPolicy>
+typename gap_vector<T, Allocator, GrowthPolicy>::reference gap_vector<T, Allocator, GrowthPolicy>::at(size_type pos)
+{
+    if (size() <= pos) {
+        throw std::out_of_range("Index out of range");
+    }
+    return (*this)[pos];
+}
+
+template<class T, class Allocator, class GrowthPolicy>
+typename gap_vector<T, Allocator, GrowthPolicy>::const_reference gap_vector<T, Allocator, GrowthPolicy>::at(size_type pos) const
+{
+    if (size() <= pos) {
+        throw std::out_of_range("Index out of range");
+    }
+    return (*this)[pos];
+}
+
+template<class T, class Allocator, class GrowthPolicy>
+typename gap_vector<T, Allocator, GrowthPolicy>::pointer gap_vector<T, Allocator, GrowthPolicy>::linearize()
+{
+    move_gap(size());
+    return data_;
+}
+
+template<class T, class Allocator, class GrowthPolicy>
+template<class... Args>
+typename gap_vector<T, Allocator, GrowthPolicy>::reference gap_vector<T, Allocator, GrowthPolicy>::emplace_back(Args&& ...args)
+{
+    return *emplace(cend(), std::forward<Args>(args)...);
+}
+
+template<class T, class Allocator, class GrowthPolicy>
+void gap_vector<T, Allocator, GrowthPolicy>::push_back(const T& elem)
+{
+    insert(cend(), elem);
+}
+
+template<class T, class Allocator, class GrowthPolicy>
+void gap_vector<T, Allocator, GrowthPolicy>::push_back(T&& elem)
+{
+    insert(cend(), std::move(elem));
+}
+
+template<class T, class Allocator, class GrowthPolicy>
+void gap_vector<T, Allocator, GrowthPolicy>::pop_back()
+{
+    if (!empty()) {
+        erase(cend() - 1);
+    }
+}
+
+template<class T, class Allocator, class GrowthPolicy>
+template<class... Args>
+typename gap_vector<T, Allocator, GrowthPolicy>::iterator
+gap_vector<T, Allocator, GrowthPolicy>::emplace(const_iterator position, Args&&... args)
+{
+    auto index = static_cast<size_type>(position.index());
+
+    //args may refer to our own elements, which growing or moving the gap would relocate,
+    //so build the value first unless it can go straight into the gap
+    if (gap_size() == 0 || gap_begin_ != index) {
+        T value(std::forward<Args>(args)...);
+        return emplace_at(index, std::move(value));
+    }
+    return emplace_at(index, std::forward<Args>(args)...);
+}
+
+template<class T, class Allocator, class GrowthPolicy>
+typename gap_vector<T, Allocator, GrowthPolicy>::iterator gap_vector<T, Allocator, GrowthPolicy>::insert(const_iterator position, const T& elem)
+{
+    auto index = static_cast<size_type>(position.index());
+    if (in_buffer(elem)) {
+        return emplace_at(index, T(elem));
+    }
+    return emplace_at(index, elem);
+}
+
+template<class T, class Allocator, class GrowthPolicy>
+typename gap_vector<T, Allocator, GrowthPolicy>::iterator gap_vector<T, Allocator, GrowthPolicy>::insert(const_iterator position, T&& elem)
+{
+    auto index = static_cast<size_type>(position.index());
+    if (in_buffer(elem)) {
+        return emplace_at(index, T(std::move(elem)));
+    }
+    return emplace_at(index, std::move(elem));
+}
+
+template<class T, class Allocator, class GrowthPolicy>
+typename gap_vector<T, Allocator, GrowthPolicy>::iterator
+gap_vector<T, Allocator, GrowthPolicy>::insert(const_iterator position, size_type n, const T& elem)
+{
+    if (in_buffer(elem)) {
+        T value(elem);
+        return insert(position, n, value);
+    }
+
+    auto index = static_cast<size_type>(position.index());
+
+    grow_gap(n);
+    move_gap(index);
+    for (size_type i = 0; i < n; i++, gap_begin_++) {
+        std::allocator_traits<Allocator>::construct(allocator_, std::addressof(*(data_ + gap_begin_)), elem);
+    }
+
+    return iterator(this, index);
+}
+
+template<class T, class Allocator, class GrowthPolicy>
+template<class InputIterator, class>
+typename gap_vector<T, Allocator, GrowthPolicy>::iterator
+gap_vector<T, Allocator, GrowthPolicy>::insert(const_iterator position, InputIterator first, InputIterator last)
+{
+    auto index = static_cast<size_type>(position.index());
+
+    grow_gap(static_cast<size_type>(std::distance(first, last)));
+    move_gap(index);
+    for (auto it = first; it != last; it++, gap_begin_++) {
+        std::allocator_traits<Allocator>::construct(allocator_, std::addressof(*(data_ + gap_begin_)), *it);
+    }
+
+    return iterator(this, index);
+}
+
+template<class T, class Allocator, class GrowthPolicy>
+typename gap_vector<T, Allocator, GrowthPolicy>::iterator
+gap_vector<T, Allocator, GrowthPolicy>::insert(const_iterator position, std::initializer_list<T> ilist)
+{
+    return insert(position, ilist.begin(), ilist.end());
+}
+
+template<class T, class Allocator, class GrowthPolicy>
+typename gap_vector<T, Allocator, GrowthPolicy>::iterator gap_vector<T, Allocator, GrowthPolicy>::erase(const_iterator position)
+{
+    return erase(position, position + 1);
+}
+
+//Moves the gap to first and widens it over the erased elements.
+template<class T, class Allocator, class GrowthPolicy>
+typename gap_vector<T, Allocator, GrowthPolicy>::iterator
+gap_vector<T, Allocator, GrowthPolicy>::erase(const_iterator first, const_iterator last)
+{
+    auto index = static_cast<size_type>(first.index());
+    auto count = static_cast<size_type>(last - first);
+
+    if (count == 0) {
+        return iterator(this, index);
+    }
+
+    move_gap(index);
+    for (size_type i = 0; i < count; i++, gap_end_++) {
+        std::allocator_traits<Allocator>::destroy(allocator_, std::addressof(*(data_ + gap_end_)));
+    }
+
+    return iterator(this, index);
+}
+
+template<class T, class Allocator, class GrowthPolicy>
+void gap_vector<T, Allocator, GrowthPolicy>::swap(gap_vector& other) noexcept
+{
+    if constexpr (std::allocator_traits<Allocator>::propagate_on_container_swap::value) {
+        using std::swap;
+        swap(allocator_, other.allocator_);
+    }
+    swap_storage(other);
+}
+
+template<class T, class Allocator, class GrowthPolicy>
+void gap_vector<T, Allocator, GrowthPolicy>::clear() noexcept
+{
+    for (size_type i = 0; i < gap_begin_; i++) {
+        std::allocator_traits<Allocator>::destroy(allocator_, std::addressof(*(data_ + i)));
+    }
+    for (size_type i = gap_end_; i < capacity_; i++) {
+        std::allocator_traits<Allocator>::destroy(allocator_, std::addressof(*(data_ + i)));
+    }
+    gap_begin_ = 0;
+    gap_end_   = capacity_;
+}
+
+//Relocates the elements between the gap and index across it, so the gap starts at index.
+//Opens a slot at index and constructs the element there; args must not refer into the buffer.
+template<class T, class Allocator, class GrowthPolicy>
+template<class... Args>
+typename gap_vector<T, Allocator, GrowthPolicy>::iterator gap_vector<T, Allocator, GrowthPolicy>::emplace_at(size_type index, Args&&... args)
+{
+    grow_gap(1);
+    move_gap(index);
+    std::allocator_traits<Allocator>::construct(allocator_, std::addressof(*(data_ + gap_begin_)), std::forward<Args>(args)...);
+    ++gap_begin_;
+
+    return iterator(this, index);
+}
+
+template<class T, class Allocator, class GrowthPolicy>
+void gap_vector<T, Allocator, GrowthPolicy>::move_gap(size_type index)
+{
+    if (index < gap_begin_) {
+        auto n = gap_begin_ - index;
+        atl::relocate_overlapping(allocator_, data_ + index, n, data_ + gap_end_ - n);
+        gap_begin_ -= n;
+        gap_end_   -= n;
+    } else if (index > gap_begin_) {
+        auto n = index - gap_begin_;
+        atl::relocate_overlapping(allocator_, data_ + gap_end_, n, data_ + gap_begin_);
+        gap_begin_ += n;
+        gap_end_   += n;
+    }
+}
+
+//Makes the gap at least `needed` slots wide, keeping its position.
+template<class T, class Allocator, class GrowthPolicy>
+void gap_vector<T, Allocator, GrowthPolicy>::grow_gap(size_type needed)
+{
+    if (gap_size() >= needed) {
+        return;
+    }
+
+    auto capacity   = GrowthPolicy::round_capacity(GrowthPolicy::next_capacity(capacity_, size() + needed), sizeof(T));
+    auto allocation = atl::allocate_at_least(allocator_, capacity);
+    auto tail       = capacity_ - gap_end_;
+
+    atl::relocate(allocator_, data_, gap_begin_, allocation.ptr);
+    atl::relocate(allocator_, data_ + gap_end_, tail, allocation.ptr + (allocation.count - tail));
+
+    if (data_ != nullptr) {
+        std::allocator_traits<Allocator>::deallocate(allocator_, data_, capacity_);
+    }
+    data_     = allocation.ptr;
+    capacity_ = allocation.count;
+    gap_end_  = capacity_ - tail;
+}
+
+template<class T, class Allocator, class GrowthPolicy>
+void gap_vector<T, Allocator, GrowthPolicy>::release() noexcept
+{
+    clear();
+    if (data_ != nullptr) {
+        std::allocator_traits<Allocator>::deallocate(allocator_, data_, capacity_);
+    }
+    data_      = nullptr;
+    capacity_  = 0;
+    gap_begin_ = 0;
+    gap_end_   = 0;
+}
+
+template<class T, class Allocator, class GrowthPolicy>
+void gap_vector<T, Allocator, GrowthPolicy>::swap_storage(gap_vector& other) noexcept
+{
+    std::swap(data_, other.data_);
+    std::swap(capacity_, other.capacity_);
+    std::swap(gap_begin_, other.gap_begin_);
+    std::swap(gap_end_, other.gap_end_);
+}
+
+template<class T, class Allocator, class GrowthPolicy>
+bool gap_vector<T, Allocator, GrowthPolicy>::in_buffer(const T& elem) const noexcept
+{
+    if (data_ == nullptr) {
+        return false;
+    }
+
+    std::less<const T*> less;
+    auto address = std::addressof(elem);
+    auto first   = std::addressof(*data_);
+    return !less(address, first) && less(address, first + capacity_);
+}
+
+template <class T, class Allocator, class GrowthPolicy>
+bool operator==(const gap_vector<T, Allocator, GrowthPolicy>& lhs, const gap_vector<T, Allocator, GrowthPolicy>& rhs)
+{
+    return lhs.size() == rhs.size() && std::equal(lhs.begin(), lhs.end(), rhs.begin());
+}
+
+template <class T, class Allocator, class GrowthPolicy>
+bool operator!=(const gap_vector<T, Allocator, GrowthPolicy>& lhs, const gap_vector<T, Allocator, GrowthPolicy>& rhs)
+{
+    return !(lhs == rhs);
+}
+
+template <class T, class Allocator, class GrowthPolicy>
+void swap(gap_vector<T, Allocator, GrowthPolicy>& lhs, gap_vector<T, Allocator, GrowthPolicy>& rhs) noexcept
+{
+    lhs.swap(rhs);
+}
+
+} //namespace atl
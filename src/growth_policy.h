@@ -0,0 +1,85 @@
+#pragma once
+
+#include <limits>
+#include <cstddef>
+#include <algorithm>
+
+namespace atl {
+
+//Rounding strategies for basic_growth_policy. Each maps a request in bytes to the number of
+//bytes actually worth allocating.
+struct no_rounding
+{
+    static constexpr std::size_t round_bytes(std::size_t bytes) noexcept { return bytes; }
+};
+
+//rounds to the next power of two, matching the size classes of typical malloc implementations
+struct power_of_two_rounding
+{
+    static constexpr std::size_t round_bytes(std::size_t bytes) noexcept
+    {
+        std::size_t rounded = 1;
+        while (rounded < bytes && rounded <= std::numeric_limits<std::size_t>::max() / 2) {
+            rounded *= 2;
+        }
+        return std::max(rounded, bytes);
+    }
+};
+
+template <std::size_t PageSize = 4096>
+struct page_rounding
+{
+    static_assert(PageSize != 0, "page_rounding: page size must be positive");
+
+    static constexpr std::size_t round_bytes(std::size_t bytes) noexcept
+    {
+        auto pages = bytes / PageSize + (bytes % PageSize != 0);
+        return pages <= std::numeric_limits<std::size_t>::max() / PageSize ? pages * PageSize : bytes;
+    }
+};
+
+//Growth policy of atl::vector.
+//  min_capacity    - capacity of the first allocation
+//  allocate_empty  - whether a default-constructed vector allocates min_capacity up front
+//  next_capacity() - capacity to grow to once `required` elements no longer fit into `capacity`
+//  round_capacity()- capacity actually requested from the allocator for n elements of elem_size bytes
+template <std::size_t FactorNum   = 3,
+          std::size_t FactorDen   = 2,
+          std::size_t MinCapacity = 10,
+          bool AllocateEmpty      = false,
+          class Rounding          = no_rounding>
+struct basic_growth_policy
+{
+    static_assert(FactorDen != 0 && FactorNum > FactorDen, "basic_growth_policy: growth factor must be greater than 1");
+
+    static constexpr std::size_t min_capacity   = MinCapacity;
+    static constexpr bool        allocate_empty = AllocateEmpty;
+
+    static constexpr std::size_t next_capacity(std::size_t capacity, std::size_t required) noexcept
+    {
+        auto grown = capacity <= std::numeric_limits<std::size_t>::max() / FactorNum
+                     ? capacity * FactorNum / FactorDen
+                     : std::numeric_limits<std::size_t>::max();
+        return std::max({grown, required, min_capacity});
+    }
+
+    static constexpr std::size_t round_capacity(std::size_t n, std::size_t elem_size) noexcept
+    {
+        if (n == 0 || n > std::numeric_limits<std::size_t>::max() / elem_size) {
+            return n;
+        }
+        return Rounding::round_bytes(n * elem_size) / elem_size;
+    }
+};
+
+//1.5x growth, first allocation of 10 elements, nothing allocated until the first insertion
+using default_growth_policy = basic_growth_policy<>;
+
+//2x growth with allocations rounded to malloc-style power-of-two size classes
+using size_class_growth_policy = basic_growth_policy<2, 1, 1, false, power_of_two_rounding>;
+
+//2x growth with allocations rounded to whole pages, for large buffers
+template <std::size_t PageSize = 4096>
+using page_growth_policy = basic_growth_policy<2, 1, 1, false, page_rounding<PageSize>>;
+
+} //namespace atl
@@ -0,0 +1,145 @@
+#pragma once
+
+#include <new>
+#include <limits>
+#include <cstdint>
+#include <cstddef>
+#include <type_traits>
+#include "allocator_support.h"
+
+#if defined(__linux__)
+#include <sys/mman.h>
+#endif
+
+namespace atl {
+
+//Allocator serving blocks of at least Threshold bytes from 2 MB-aligned anonymous mappings
+//advised with MADV_HUGEPAGE, so large buffers are backed by transparent huge pages and random
+//access stops thrashing the TLB. Smaller blocks come from the regular heap.
+//On platforms without mmap every block comes from the heap.
+template <class T, std::size_t Threshold = (std::size_t(1) << 21)>
+class huge_page_allocator
+{
+public:
+    static constexpr std::size_t huge_page_size = std::size_t(1) << 21;
+
+    using value_type                             = T;
+    using size_type                              = std::size_t;
+    using difference_type                        = std::ptrdiff_t;
+    using propagate_on_container_move_assignment = std::true_type;
+    using is_always_equal                        = std::true_type;
+
+    template <class U>
+    struct rebind { using other = huge_page_allocator<U, Threshold>; };
+
+    huge_page_allocator() noexcept = default;
+    template <class U> huge_page_allocator(const huge_page_allocator<U, Threshold>&) noexcept {}
+
+    T* allocate(size_type n);
+    //huge blocks report the whole rounded-up mapping as usable
+    allocation_result<T*> allocate_at_least(size_type n);
+    void deallocate(T* p, size_type n) noexcept;
+
+    size_type max_size() const noexcept { return std::numeric_limits<size_type>::max() / sizeof(T) / 2; }
+
+    template <class U>
+    friend bool operator==(const huge_page_allocator&, const huge_page_allocator<U, Threshold>&) noexcept { return true; }
+
+    template <class U>
+    friend bool operator!=(const huge_page_allocator&, const huge_page_allocator<U, Threshold>&) noexcept { return false; }
+
+private:
+    static bool is_huge(size_type bytes) noexcept;
+    static size_type round_to_huge_page(size_type bytes) noexcept;
+    static T* map_huge(size_type bytes);
+};
+
+template<class T, std::size_t Threshold>
+T* huge_page_allocator<T, Threshold>::allocate(size_type n)
+{
+    return allocate_at_least(n).ptr;
+}
+
+template<class T, std::size_t Threshold>
+allocation_result<T*> huge_page_allocator<T, Threshold>::allocate_at_least(size_type n)
+{
+    if (n > max_size()) {
+        throw std::bad_array_new_length();
+    }
+
+    auto bytes = n * sizeof(T);
+
+    if (!is_huge(bytes)) {
+        return {static_cast<T*>(::operator new(bytes, std::align_val_t(alignof(T)))), n};
+    }
+
+    auto mapped = round_to_huge_page(bytes);
+    return {map_huge(mapped), mapped / sizeof(T)};
+}
+
+template<class T, std::size_t Threshold>
+void huge_page_allocator<T, Threshold>::deallocate(T* p, size_type n) noexcept
+{
+    auto bytes = n * sizeof(T);
+
+    if (!is_huge(bytes)) {
+        ::operator delete(p, std::align_val_t(alignof(T)));
+        return;
+    }
+
+#if defined(__linux__)
+    munmap(p, round_to_huge_page(bytes));
+#endif
+}
+
+template<class T, std::size_t Threshold>
+bool huge_page_allocator<T, Threshold>::is_huge(size_type bytes) noexcept
+{
+#if defined(__linux__)
+    return bytes >= Threshold && bytes != 0;
+#else
+    (void)bytes;
+    return false;
+#endif
+}
+
+template<class T, std::size_t Threshold>
+typename huge_page_allocator<T, Threshold>::size_type huge_page_allocator<T, Threshold>::round_to_huge_page(size_type bytes) noexcept
+{
+    return (bytes + huge_page_size - 1) / huge_page_size * huge_page_size;
+}
+
+template<class T, std::size_t Threshold>
+T* huge_page_allocator<T, Threshold>::map_huge(size_type bytes)
+{
+#if defined(__linux__)
+    //over-map by one huge page and trim both ends to get a 2 MB-aligned region
+    auto span = bytes + huge_page_size;
+    void* raw = mmap(nullptr, span, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (raw == MAP_FAILED) {
+        throw std::bad_alloc();
+    }
+
+    auto begin   = reinterpret_cast<std::uintptr_t>(raw);
+    auto aligned = (begin + huge_page_size - 1) / huge_page_size * huge_page_size;
+    auto head    = aligned - begin;
+    auto tail    = span - head - bytes;
+
+    if (head != 0) {
+        munmap(raw, head);
+    }
+    if (tail != 0) {
+        munmap(reinterpret_cast<void*>(aligned + bytes), tail);
+    }
+
+#if defined(MADV_HUGEPAGE)
+    madvise(reinterpret_cast<void*>(aligned), bytes, MADV_HUGEPAGE);
+#endif
+    return reinterpret_cast<T*>(aligned);
+#else
+    (void)bytes;
+    throw std::bad_alloc();
+#endif
+}
+
+} //namespace atl
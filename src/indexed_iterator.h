@@ -0,0 +1,63 @@
+#pragma once
+
+#include <memory>
+#include <cstddef>
+#include <iterator>
+#include <type_traits>
+
+namespace atl {
+
+//Random-access iterator for containers without a single contiguous buffer (gap_vector,
+//segmented_vector). It stores the container and a logical index and goes through operator[].
+template <class Container, bool is_const>
+class IndexedIterator
+{
+    using container_pointer = typename std::conditional<is_const, const Container*, Container*>::type;
+    using element_type      = typename Container::value_type;
+
+public:
+    using size_type         = std::size_t;
+    using difference_type   = std::ptrdiff_t;
+    using value_type        = element_type;
+    using reference         = typename std::conditional<is_const, const element_type&, element_type&>::type;
+    using pointer           = typename std::conditional<is_const, const element_type*, element_type*>::type;
+    using iterator_category = std::random_access_iterator_tag;
+
+    IndexedIterator() : container_(nullptr), pos_(0) {}
+    IndexedIterator(container_pointer container, difference_type pos) : container_(container), pos_(pos) {}
+
+    //implicit cast
+    operator IndexedIterator<Container, true>() const { return IndexedIterator<Container, true>(container_, pos_); }
+
+    reference operator*() const { return (*container_)[pos_]; }
+    pointer operator->() const { return std::addressof(**this); }
+    reference operator[](difference_type n) const { return (*container_)[pos_ + n]; }
+
+    IndexedIterator& operator++() { ++pos_; return *this; }
+    IndexedIterator operator++(int) { auto tmp = *this; ++pos_; return tmp; }
+    IndexedIterator& operator--() { --pos_; return *this; }
+    IndexedIterator operator--(int) { auto tmp = *this; --pos_; return tmp; }
+
+    IndexedIterator& operator+=(difference_type n) { pos_ += n; return *this; }
+    IndexedIterator& operator-=(difference_type n) { pos_ -= n; return *this; }
+
+    friend IndexedIterator operator+(IndexedIterator it, difference_type n) { return it += n; }
+    friend IndexedIterator operator+(difference_type n, IndexedIterator it) { return it += n; }
+    friend IndexedIterator operator-(IndexedIterator it, difference_type n) { return it -= n; }
+    friend difference_type operator-(const IndexedIterator& lhs, const IndexedIterator& rhs) { return lhs.pos_ - rhs.pos_; }
+
+    friend bool operator==(const IndexedIterator& lhs, const IndexedIterator& rhs) { return lhs.pos_ == rhs.pos_; }
+    friend bool operator!=(const IndexedIterator& lhs, const IndexedIterator& rhs) { return lhs.pos_ != rhs.pos_; }
+    friend bool operator<(const IndexedIterator& lhs, const IndexedIterator& rhs)  { return lhs.pos_ < rhs.pos_; }
+    friend bool operator>(const IndexedIterator& lhs, const IndexedIterator& rhs)  { return lhs.pos_ > rhs.pos_; }
+    friend bool operator<=(const IndexedIterator& lhs, const IndexedIterator& rhs) { return lhs.pos_ <= rhs.pos_; }
+    friend bool operator>=(const IndexedIterator& lhs, const IndexedIterator& rhs) { return lhs.pos_ >= rhs.pos_; }
+
+    difference_type index() const noexcept { return pos_; }
+
+private:
+    container_pointer container_;
+    difference_type pos_;
+};
+
+} //namespace atl
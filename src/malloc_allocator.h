@@ -0,0 +1,105 @@
+#pragma once
+
+#include <new>
+#include <limits>
+#include <cstdlib>
+#include <algorithm>
+#include <cstddef>
+#include <type_traits>
+#include "allocator_support.h"
+
+#if defined(__GLIBC__)
+#include <malloc.h>
+#endif
+
+namespace atl {
+
+//Stateless allocator on top of malloc/realloc/free. Supports in-place growth through
+//reallocate(), which lets atl::vector extend trivially relocatable buffers without a copy.
+//glibc serves large blocks with mmap and grows them with mremap, so growing a huge buffer
+//is page-table work rather than an O(n) copy.
+//allocate_at_least() and reallocate() report the usable size of the malloc block where the
+//libc exposes it.
+template <class T>
+class malloc_allocator
+{
+public:
+    static_assert(alignof(T) <= alignof(std::max_align_t), "malloc_allocator: over-aligned types are not supported");
+
+    using value_type                             = T;
+    using size_type                              = std::size_t;
+    using difference_type                        = std::ptrdiff_t;
+    using propagate_on_container_move_assignment = std::true_type;
+    using is_always_equal                        = std::true_type;
+
+    malloc_allocator() noexcept = default;
+    template <class U> malloc_allocator(const malloc_allocator<U>&) noexcept {}
+
+    T* allocate(size_type n);
+    allocation_result<T*> allocate_at_least(size_type n);
+    void deallocate(T* p, size_type n) noexcept;
+    allocation_result<T*> reallocate(T* p, size_type old_n, size_type new_n) noexcept;
+
+    size_type max_size() const noexcept { return std::numeric_limits<size_type>::max() / sizeof(T); }
+
+    template <class U>
+    friend bool operator==(const malloc_allocator&, const malloc_allocator<U>&) noexcept { return true; }
+
+    template <class U>
+    friend bool operator!=(const malloc_allocator&, const malloc_allocator<U>&) noexcept { return false; }
+
+private:
+    //elements that fit in the block p was given for a request of n
+    static size_type usable_size(T* p, size_type n) noexcept;
+};
+
+template<class T>
+T* malloc_allocator<T>::allocate(size_type n)
+{
+    if (n > max_size()) {
+        throw std::bad_array_new_length();
+    }
+
+    auto p = static_cast<T*>(std::malloc(n * sizeof(T)));
+    if (p == nullptr && n != 0) {
+        throw std::bad_alloc();
+    }
+    return p;
+}
+
+template<class T>
+allocation_result<T*> malloc_allocator<T>::allocate_at_least(size_type n)
+{
+    auto p = allocate(n);
+    return {p, usable_size(p, n)};
+}
+
+template<class T>
+void malloc_allocator<T>::deallocate(T* p, size_type) noexcept
+{
+    std::free(p);
+}
+
+template<class T>
+allocation_result<T*> malloc_allocator<T>::reallocate(T* p, size_type, size_type new_n) noexcept
+{
+    if (new_n == 0 || new_n > max_size()) {
+        return {nullptr, 0};
+    }
+    auto resized = static_cast<T*>(std::realloc(p, new_n * sizeof(T)));
+    return {resized, usable_size(resized, new_n)};
+}
+
+template<class T>
+typename malloc_allocator<T>::size_type malloc_allocator<T>::usable_size(T* p, size_type n) noexcept
+{
+#if defined(__GLIBC__)
+    if (p != nullptr) {
+        return std::max(n, malloc_usable_size(p) / sizeof(T));
+    }
+#endif
+    (void)p;
+    return n;
+}
+
+} //namespace atl
@@ -0,0 +1,111 @@
+#pragma once
+
+#include <new>
+#include <limits>
+#include <cstddef>
+#include <type_traits>
+#include "vector.h"
+#include "growth_policy.h"
+#include "allocator_support.h"
+
+#include <sys/mman.h>
+#include <unistd.h>
+
+namespace atl {
+
+//Allocator handing out whole anonymous mappings. Blocks grow through mremap(MREMAP_MAYMOVE)
+//where available (Linux), so the kernel moves page-table entries instead of the vector copying
+//its elements, and there is no moment where old and new buffers both exist.
+template <class T>
+class mmap_allocator
+{
+public:
+    using value_type                             = T;
+    using size_type                              = std::size_t;
+    using difference_type                        = std::ptrdiff_t;
+    using propagate_on_container_move_assignment = std::true_type;
+    using is_always_equal                        = std::true_type;
+
+    mmap_allocator() noexcept = default;
+    template <class U> mmap_allocator(const mmap_allocator<U>&) noexcept {}
+
+    T* allocate(size_type n);
+    //mappings are page granular; the rest of the last page is reported as usable
+    allocation_result<T*> allocate_at_least(size_type n);
+    void deallocate(T* p, size_type n) noexcept;
+    allocation_result<T*> reallocate(T* p, size_type old_n, size_type new_n) noexcept;
+
+    size_type max_size() const noexcept { return std::numeric_limits<size_type>::max() / sizeof(T) / 2; }
+
+    template <class U>
+    friend bool operator==(const mmap_allocator&, const mmap_allocator<U>&) noexcept { return true; }
+
+    template <class U>
+    friend bool operator!=(const mmap_allocator&, const mmap_allocator<U>&) noexcept { return false; }
+
+private:
+    static size_type mapping_size(size_type n) noexcept;
+};
+
+template<class T>
+T* mmap_allocator<T>::allocate(size_type n)
+{
+    return allocate_at_least(n).ptr;
+}
+
+template<class T>
+allocation_result<T*> mmap_allocator<T>::allocate_at_least(size_type n)
+{
+    if (n > max_size()) {
+        throw std::bad_array_new_length();
+    }
+
+    auto bytes = mapping_size(n);
+    void* p = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (p == MAP_FAILED) {
+        throw std::bad_alloc();
+    }
+    return {static_cast<T*>(p), bytes / sizeof(T)};
+}
+
+template<class T>
+void mmap_allocator<T>::deallocate(T* p, size_type n) noexcept
+{
+    munmap(p, mapping_size(n));
+}
+
+template<class T>
+allocation_result<T*> mmap_allocator<T>::reallocate(T* p, size_type old_n, size_type new_n) noexcept
+{
+#if defined(__linux__) && defined(MREMAP_MAYMOVE)
+    if (new_n > max_size()) {
+        return {nullptr, 0};
+    }
+
+    auto bytes = mapping_size(new_n);
+    void* resized = mremap(p, mapping_size(old_n), bytes, MREMAP_MAYMOVE);
+    if (resized == MAP_FAILED) {
+        return {nullptr, 0};
+    }
+    return {static_cast<T*>(resized), bytes / sizeof(T)};
+#else
+    (void)p; (void)old_n; (void)new_n;
+    return {nullptr, 0};
+#endif
+}
+
+template<class T>
+typename mmap_allocator<T>::size_type mmap_allocator<T>::mapping_size(size_type n) noexcept
+{
+    static const size_type page = static_cast<size_type>(sysconf(_SC_PAGESIZE));
+    auto bytes = n * sizeof(T);
+    return bytes == 0 ? page : (bytes + page - 1) / page * page;
+}
+
+//Growable vector whose buffer is an anonymous mapping. For trivially relocatable T growth is a
+//mremap, which removes the O(n) copy and the transient 2x footprint of ordinary reallocation;
+//other types fall back to the usual allocate/relocate/free path.
+template <class T>
+using mmap_vector = vector<T, mmap_allocator<T>, page_growth_policy<>>;
+
+} //namespace atl
@@ -0,0 +1,152 @@
+#pragma once
+
+#include <cstddef>
+#include <utility>
+#include <optional>
+#include <algorithm>
+#include "vector.h"
+#include "thread_pool.h"
+
+namespace atl {
+namespace parallel {
+
+//Parallel algorithms over atl::vector. Each chunk works on raw pointers into data(), so the
+//inner loops are the same tight loops a serial version would compile to. Every algorithm
+//takes an optional thread_pool as its first argument and uses thread_pool::default_pool()
+//otherwise. reduce and transform_reduce combine per-chunk results in chunk order, so op must
+//be associative but need not be commutative, and the result does not depend on scheduling.
+
+namespace detail {
+
+//elements per chunk: enough chunks for stealing to balance load, none too small to amortize
+inline std::size_t grain_for(std::size_t n, const thread_pool& pool)
+{
+    constexpr std::size_t chunks_per_thread = 8;
+    constexpr std::size_t min_grain = 4096;
+
+    auto chunks = pool.concurrency() * chunks_per_thread;
+    return std::max(min_grain, (n + chunks - 1) / chunks);
+}
+
+inline std::size_t chunk_count(std::size_t n, const thread_pool& pool)
+{
+    auto grain = grain_for(n, pool);
+    return (n + grain - 1) / grain;
+}
+
+//Runs chunk(c, first, last) for every chunk [first, last) of [0, n), c counting from 0.
+template <class F>
+void for_each_chunk(thread_pool& pool, std::size_t n, F&& chunk)
+{
+    auto grain = grain_for(n, pool);
+    pool.for_range(chunk_count(n, pool), 1, [&](std::size_t begin, std::size_t end) {
+        for (auto c = begin; c != end; c++) {
+            chunk(c, c * grain, std::min(n, (c + 1) * grain));
+        }
+    });
+}
+
+//Folds transform(first[i]) over one chunk, starting from its first element so no identity is needed.
+template <class R, class T, class ReduceOp, class TransformOp>
+R fold_chunk(const T* first, const T* last, ReduceOp& reduce, TransformOp& transform)
+{
+    R acc = transform(*first);
+    for (++first; first != last; ++first) {
+        acc = reduce(std::move(acc), transform(*first));
+    }
+    return acc;
+}
+
+} //namespace detail
+
+template <class T, class Allocator, class GrowthPolicy, class F>
+void for_each(thread_pool& pool, vector<T, Allocator, GrowthPolicy>& v, F f)
+{
+    auto data = v.data();
+    pool.for_range(v.size(), detail::grain_for(v.size(), pool), [data, &f](std::size_t begin, std::size_t end) {
+        for (auto p = data + begin, last = data + end; p != last; ++p) {
+            f(*p);
+        }
+    });
+}
+
+template <class T, class Allocator, class GrowthPolicy, class F>
+void for_each(vector<T, Allocator, GrowthPolicy>& v, F f)
+{
+    for_each(thread_pool::default_pool(), v, std::move(f));
+}
+
+//Resizes out to in.size() and sets out[i] = f(in[i]); in and out may be the same vector.
+template <class T, class Allocator, class GrowthPolicy, class U, class UAllocator, class UGrowthPolicy, class F>
+void transform(thread_pool& pool, const vector<T, Allocator, GrowthPolicy>& in, vector<U, UAllocator, UGrowthPolicy>& out, F f)
+{
+    out.resize(in.size());
+    auto src = in.data();
+    auto dst = out.data();
+    pool.for_range(in.size(), detail::grain_for(in.size(), pool), [src, dst, &f](std::size_t begin, std::size_t end) {
+        for (auto i = begin; i != end; i++) {
+            dst[i] = f(src[i]);
+        }
+    });
+}
+
+template <class T, class Allocator, class GrowthPolicy, class U, class UAllocator, class UGrowthPolicy, class F>
+void transform(const vector<T, Allocator, GrowthPolicy>& in, vector<U, UAllocator, UGrowthPolicy>& out, F f)
+{
+    transform(thread_pool::default_pool(), in, out, std::move(f));
+}
+
+template <class T, class Allocator, class GrowthPolicy, class R, class ReduceOp, class TransformOp>
+R transform_reduce(thread_pool& pool, const vector<T, Allocator, GrowthPolicy>& v, R init, ReduceOp reduce, TransformOp transform)
+{
+    if (v.empty()) {
+        return init;
+    }
+
+    auto data = v.data();
+    vector<std::optional<R>> partials(detail::chunk_count(v.size(), pool));
+    detail::for_each_chunk(pool, v.size(), [&](std::size_t c, std::size_t first, std::size_t last) {
+        partials[c].emplace(detail::fold_chunk<R>(data + first, data + last, reduce, transform));
+    });
+
+    for (auto& partial : partials) {
+        init = reduce(std::move(init), std::move(*partial));
+    }
+    return init;
+}
+
+template <class T, class Allocator, class GrowthPolicy, class R, class ReduceOp, class TransformOp>
+R transform_reduce(const vector<T, Allocator, GrowthPolicy>& v, R init, ReduceOp reduce, TransformOp transform)
+{
+    return transform_reduce(thread_pool::default_pool(), v, std::move(init), std::move(reduce), std::move(transform));
+}
+
+template <class T, class Allocator, class GrowthPolicy, class R, class ReduceOp>
+R reduce(thread_pool& pool, const vector<T, Allocator, GrowthPolicy>& v, R init, ReduceOp op)
+{
+    return transform_reduce(pool, v, std::move(init), std::move(op), [](const T& elem) -> const T& { return elem; });
+}
+
+template <class T, class Allocator, class GrowthPolicy, class R, class ReduceOp>
+R reduce(const vector<T, Allocator, GrowthPolicy>& v, R init, ReduceOp op)
+{
+    return reduce(thread_pool::default_pool(), v, std::move(init), std::move(op));
+}
+
+template <class T, class Allocator, class GrowthPolicy, class Predicate>
+typename vector<T, Allocator, GrowthPolicy>::size_type count_if(thread_pool& pool, const vector<T, Allocator, GrowthPolicy>& v, Predicate pred)
+{
+    using size_type = typename vector<T, Allocator, GrowthPolicy>::size_type;
+    return transform_reduce(pool, v, size_type(0),
+                            [](size_type lhs, size_type rhs) { return lhs + rhs; },
+                            [&pred](const T& elem) -> size_type { return pred(elem) ? 1 : 0; });
+}
+
+template <class T, class Allocator, class GrowthPolicy, class Predicate>
+typename vector<T, Allocator, GrowthPolicy>::size_type count_if(const vector<T, Allocator, GrowthPolicy>& v, Predicate pred)
+{
+    return count_if(thread_pool::default_pool(), v, std::move(pred));
+}
+
+} //namespace parallel
+} //namespace atl
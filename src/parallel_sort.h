@@ -0,0 +1,239 @@
+#pragma once
+
+#include <cstddef>
+#include <utility>
+#include <iterator>
+#include <algorithm>
+#include <functional>
+#include <type_traits>
+#include "vector.h"
+#include "thread_pool.h"
+
+namespace atl {
+
+//Parallel merge sort over atl::vector. The vector is cut into one block per thread, blocks
+//are sorted concurrently, and then runs are merged pairwise, doubling in length each pass.
+//Every pass is split into output ranges of equal size, each located in both input runs by a
+//binary search, so even the last merge of two halves keeps all threads busy.
+//
+//Merging needs a second buffer of v.size() elements. It is taken from scratch when one is
+//passed (scratch is resized if smaller, so reserving it once lets repeated sorts skip the
+//allocation) and its elements are left moved-from. T must be default constructible and move
+//assignable. If comp throws, the exception is rethrown and v holds its elements in
+//unspecified order, some possibly moved-from.
+
+namespace detail {
+
+//blocks and merge ranges smaller than this are not worth a task of their own
+constexpr std::size_t sort_min_block = 8192;
+//length of the runs insertion-sorted before merging within a block
+constexpr std::size_t sort_insertion_run = 32;
+
+//Number of elements taken from a[0, m) among the first k of the stable merge of a and b.
+template <class RandomIt, class Compare>
+std::size_t merge_split(RandomIt a, std::size_t m, RandomIt b, std::size_t n, std::size_t k, Compare& comp)
+{
+    auto lo = k > n ? k - n : 0;
+    auto hi = std::min(k, m);
+    while (lo < hi) {
+        auto mid = lo + (hi - lo) / 2;
+        if (!comp(b[k - mid - 1], a[mid])) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    return lo;
+}
+
+//Elements of the first run taken among the output positions of its pair that precede pos,
+//in the pass merging adjacent runs of length run in src[0, n).
+template <class RandomIt, class Compare>
+std::size_t split_at(RandomIt src, std::size_t n, std::size_t run, std::size_t pos, Compare& comp)
+{
+    auto start = pos / (2 * run) * (2 * run);
+    auto m = std::min(run, n - start);
+    return merge_split(src + start, m, src + start + m, std::min(run, n - start - m), pos - start, comp);
+}
+
+//Writes dst[first, last) of the pass merging adjacent runs of length run in src[0, n), given
+//the splits at first and last. Elements are moved out of src, so every split a pass needs must
+//be found before any range of it is merged.
+template <class RandomIt, class Compare>
+void merge_runs(RandomIt src, RandomIt dst, std::size_t n, std::size_t run, std::size_t first, std::size_t last,
+                std::size_t first_split, std::size_t last_split, Compare& comp)
+{
+    while (first != last) {
+        auto start = first / (2 * run) * (2 * run);
+        auto m = std::min(run, n - start);
+        auto pair_end = start + m + std::min(run, n - start - m);
+        auto stop = std::min(last, pair_end);
+        auto next_split = stop == pair_end ? m : last_split;
+
+        auto a = src + start;
+        auto b = a + m;
+        std::merge(std::make_move_iterator(a + first_split), std::make_move_iterator(a + next_split),
+                   std::make_move_iterator(b + (first - start - first_split)), std::make_move_iterator(b + (stop - start - next_split)),
+                   dst + first, comp);
+        first = stop;
+        first_split = 0;
+    }
+}
+
+template <class RandomIt, class Compare>
+void insertion_sort(RandomIt first, RandomIt last, Compare& comp)
+{
+    if (first == last) {
+        return;
+    }
+    for (auto i = first + 1; i != last; ++i) {
+        auto value = std::move(*i);
+        auto j = i;
+        for (; j != first && comp(value, *(j - 1)); --j) {
+            *j = std::move(*(j - 1));
+        }
+        *j = std::move(value);
+    }
+}
+
+//Serial stable sort of first[0, n) that merges through buffer[0, n) instead of allocating.
+template <class RandomIt, class Compare>
+void stable_sort_block(RandomIt first, std::size_t n, RandomIt buffer, Compare& comp)
+{
+    for (std::size_t i = 0; i < n; i += sort_insertion_run) {
+        insertion_sort(first + i, first + std::min(n, i + sort_insertion_run), comp);
+    }
+
+    auto src = first;
+    auto dst = buffer;
+    for (auto run = sort_insertion_run; run < n; run *= 2) {
+        merge_runs(src, dst, n, run, 0, n, 0, 0, comp);
+        std::swap(src, dst);
+    }
+    if (src != first) {
+        std::move(src, src + n, first);
+    }
+}
+
+template <bool Stable, class RandomIt, class Compare>
+void parallel_merge_sort(parallel::thread_pool& pool, RandomIt data, std::size_t n, RandomIt buffer, Compare& comp)
+{
+    auto threads = pool.concurrency();
+    auto block = std::max(sort_min_block, (n + threads - 1) / threads);
+    pool.for_range((n + block - 1) / block, 1, [&](std::size_t begin, std::size_t end) {
+        for (auto b = begin; b != end; b++) {
+            auto first = b * block;
+            auto length = std::min(block, n - first);
+            if (Stable) {
+                stable_sort_block(data + first, length, buffer + first, comp);
+            } else {
+                std::sort(data + first, data + first + length, comp);
+            }
+        }
+    });
+
+    auto grain = std::max(sort_min_block, (n + threads * 8 - 1) / (threads * 8));
+    auto chunks = (n + grain - 1) / grain;
+    vector<std::size_t> splits(chunks + 1);
+    auto src = data;
+    auto dst = buffer;
+    for (auto run = block; run < n; run *= 2) {
+        pool.for_range(chunks, 1, [&](std::size_t begin, std::size_t end) {
+            for (auto c = begin; c != end; c++) {
+                splits[c] = split_at(src, n, run, c * grain, comp);
+            }
+        });
+        pool.for_range(chunks, 1, [&](std::size_t begin, std::size_t end) {
+            for (auto c = begin; c != end; c++) {
+                merge_runs(src, dst, n, run, c * grain, std::min(n, (c + 1) * grain), splits[c], splits[c + 1], comp);
+            }
+        });
+        std::swap(src, dst);
+    }
+
+    if (src != data) {
+        pool.for_range(n, grain, [&](std::size_t begin, std::size_t end) {
+            std::move(src + begin, src + end, data + begin);
+        });
+    }
+}
+
+template <bool Stable, class T, class Allocator, class GrowthPolicy, class ScratchAllocator, class ScratchGrowthPolicy, class Compare>
+void parallel_sort(parallel::thread_pool& pool, vector<T, Allocator, GrowthPolicy>& v,
+                   vector<T, ScratchAllocator, ScratchGrowthPolicy>& scratch, Compare& comp)
+{
+    static_assert(std::is_default_constructible<T>::value,
+                  "parallel_sort: T must be default constructible, the scratch buffer is resized to v.size()");
+    static_assert(std::is_move_assignable<T>::value, "parallel_sort: T must be move assignable");
+
+    if (scratch.size() < v.size()) {
+        scratch.resize(v.size());
+    }
+    parallel_merge_sort<Stable>(pool, v.data(), v.size(), scratch.data(), comp);
+}
+
+} //namespace detail
+
+template <class T, class Allocator, class GrowthPolicy, class ScratchAllocator, class ScratchGrowthPolicy, class Compare = std::less<T>>
+void parallel_sort(parallel::thread_pool& pool, vector<T, Allocator, GrowthPolicy>& v,
+                   vector<T, ScratchAllocator, ScratchGrowthPolicy>& scratch, Compare comp = Compare())
+{
+    if (pool.concurrency() == 1 || v.size() <= detail::sort_min_block) {
+        std::sort(v.data(), v.data() + v.size(), comp);
+        return;
+    }
+    detail::parallel_sort<false>(pool, v, scratch, comp);
+}
+
+template <class T, class Allocator, class GrowthPolicy, class Compare = std::less<T>>
+void parallel_sort(parallel::thread_pool& pool, vector<T, Allocator, GrowthPolicy>& v, Compare comp = Compare())
+{
+    if (pool.concurrency() == 1 || v.size() <= detail::sort_min_block) {
+        std::sort(v.data(), v.data() + v.size(), comp);
+        return;
+    }
+    vector<T, Allocator, GrowthPolicy> scratch(v.get_allocator());
+    detail::parallel_sort<false>(pool, v, scratch, comp);
+}
+
+template <class T, class Allocator, class GrowthPolicy, class ScratchAllocator, class ScratchGrowthPolicy, class Compare = std::less<T>>
+void parallel_sort(vector<T, Allocator, GrowthPolicy>& v, vector<T, ScratchAllocator, ScratchGrowthPolicy>& scratch, Compare comp = Compare())
+{
+    parallel_sort(parallel::thread_pool::default_pool(), v, scratch, std::move(comp));
+}
+
+template <class T, class Allocator, class GrowthPolicy, class Compare = std::less<T>>
+void parallel_sort(vector<T, Allocator, GrowthPolicy>& v, Compare comp = Compare())
+{
+    parallel_sort(parallel::thread_pool::default_pool(), v, std::move(comp));
+}
+
+//Equal elements keep their relative order. Unlike std::stable_sort no memory beyond the
+//scratch buffer is allocated, at any size.
+template <class T, class Allocator, class GrowthPolicy, class ScratchAllocator, class ScratchGrowthPolicy, class Compare = std::less<T>>
+void parallel_stable_sort(parallel::thread_pool& pool, vector<T, Allocator, GrowthPolicy>& v,
+                          vector<T, ScratchAllocator, ScratchGrowthPolicy>& scratch, Compare comp = Compare())
+{
+    detail::parallel_sort<true>(pool, v, scratch, comp);
+}
+
+template <class T, class Allocator, class GrowthPolicy, class Compare = std::less<T>>
+void parallel_stable_sort(parallel::thread_pool& pool, vector<T, Allocator, GrowthPolicy>& v, Compare comp = Compare())
+{
+    vector<T, Allocator, GrowthPolicy> scratch(v.get_allocator());
+    detail::parallel_sort<true>(pool, v, scratch, comp);
+}
+
+template <class T, class Allocator, class GrowthPolicy, class ScratchAllocator, class ScratchGrowthPolicy, class Compare = std::less<T>>
+void parallel_stable_sort(vector<T, Allocator, GrowthPolicy>& v, vector<T, ScratchAllocator, ScratchGrowthPolicy>& scratch, Compare comp = Compare())
+{
+    parallel_stable_sort(parallel::thread_pool::default_pool(), v, scratch, std::move(comp));
+}
+
+template <class T, class Allocator, class GrowthPolicy, class Compare = std::less<T>>
+void parallel_stable_sort(vector<T, Allocator, GrowthPolicy>& v, Compare comp = Compare())
+{
+    parallel_stable_sort(parallel::thread_pool::default_pool(), v, std::move(comp));
+}
+
+} //namespace atl
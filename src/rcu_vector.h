@@ -0,0 +1,249 @@
+#pragma once
+
+#include <mutex>
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <utility>
+#include <stdexcept>
+#include "vector.h"
+#include "cache_line.h"
+
+namespace atl {
+
+//Read-mostly vector shared between threads by read-copy-update. Readers take immutable
+//snapshots wait-free (a load, a store and a load, no loop and no shared cache line written),
+//so reader latency does not depend on the writer. Writers build a new version off to the side
+//and publish it with one atomic exchange; the replaced version is freed once no reader that
+//could still see it remains inside a snapshot (epoch-based reclamation).
+//
+//Each reader thread registers once through make_reader(), which reserves one of MaxReaders
+//cache-line-sized slots, and holds at most one snapshot at a time. Writers are serialized by
+//an internal mutex that readers never touch. The rcu_vector must outlive its readers.
+template <class T, class Allocator = std::allocator<T>, std::size_t MaxReaders = 128>
+class rcu_vector {
+    struct slot;
+
+public:
+    using version_type = atl::vector<T, Allocator>;
+    using value_type   = T;
+    using size_type    = std::size_t;
+
+    //Immutable view of one published version, valid until destroyed.
+    class snapshot {
+    public:
+        snapshot(const snapshot&) = delete;
+        snapshot& operator=(const snapshot&) = delete;
+        snapshot(snapshot&& other) noexcept : version_(other.version_), epoch_(other.epoch_) { other.epoch_ = nullptr; }
+        ~snapshot() { if (epoch_ != nullptr) epoch_->store(0, std::memory_order_release); }
+
+        const T*  data() const noexcept  { return version_->data(); }
+        size_type size() const noexcept  { return version_->size(); }
+        bool      empty() const noexcept { return version_->empty(); }
+        const T*  begin() const noexcept { return data(); }
+        const T*  end() const noexcept   { return data() + size(); }
+        const T&  operator[](size_type n) const { return data()[n]; }
+
+        const version_type& version() const noexcept { return *version_; }
+
+    private:
+        friend class rcu_vector;
+
+        snapshot(const version_type* version, std::atomic<std::uint64_t>* epoch) : version_(version), epoch_(epoch) {}
+
+        const version_type* version_;
+        std::atomic<std::uint64_t>* epoch_;
+    };
+
+    //A registered reader; owns its slot until destroyed.
+    class reader {
+    public:
+        reader(const reader&) = delete;
+        reader& operator=(const reader&) = delete;
+        reader(reader&& other) noexcept : owner_(other.owner_), slot_(other.slot_) { other.slot_ = nullptr; }
+        ~reader() { if (slot_ != nullptr) slot_->in_use.store(false, std::memory_order_release); }
+
+        snapshot read() const noexcept { return owner_->enter(*slot_); }
+
+    private:
+        friend class rcu_vector;
+
+        reader(const rcu_vector* owner, slot* slot) : owner_(owner), slot_(slot) {}
+
+        const rcu_vector* owner_;
+        slot* slot_;
+    };
+
+    explicit rcu_vector(version_type initial = version_type());
+    rcu_vector(const rcu_vector&) = delete;
+    rcu_vector& operator=(const rcu_vector&) = delete;
+    ~rcu_vector();
+
+    //throws std::length_error when all MaxReaders slots are taken
+    reader make_reader() const;
+
+    //Replaces the current version.
+    void publish(version_type next);
+
+    //Copies the current version, lets edit modify the copy and publishes it.
+    template <class F>
+    void update(F&& edit);
+
+    //Frees the retired versions no reader can still see; returns how many remain.
+    size_type reclaim();
+
+    //Waits until every retired version has been freed.
+    void synchronize();
+
+    size_type retired() const;
+
+private:
+    struct alignas(cache_line_size) slot
+    {
+        //0 while outside a snapshot, otherwise the epoch seen on entry
+        std::atomic<std::uint64_t> epoch{0};
+        std::atomic<bool> in_use{false};
+    };
+
+    struct retired_version
+    {
+        version_type* version;
+        std::uint64_t epoch;
+    };
+
+    alignas(cache_line_size) std::atomic<version_type*> current_;
+    alignas(cache_line_size) std::atomic<std::uint64_t> epoch_;
+    mutable slot slots_[MaxReaders];
+
+    mutable std::mutex writer_mutex_;
+    atl::vector<retired_version> retired_;
+
+    snapshot enter(slot& s) const noexcept;
+    void publish_locked(version_type* next);
+    size_type reclaim_locked();
+};
+
+template<class T, class Allocator, std::size_t MaxReaders>
+rcu_vector<T, Allocator, MaxReaders>::rcu_vector(version_type initial)
+        : current_(new version_type(std::move(initial))),
+          epoch_(1) {}
+
+template<class T, class Allocator, std::size_t MaxReaders>
+rcu_vector<T, Allocator, MaxReaders>::~rcu_vector()
+{
+    for (auto& entry : retired_) {
+        delete entry.version;
+    }
+    delete current_.load(std::memory_order_relaxed);
+}
+
+template<class T, class Allocator, std::size_t MaxReaders>
+typename rcu_vector<T, Allocator, MaxReaders>::reader rcu_vector<T, Allocator, MaxReaders>::make_reader() const
+{
+    for (auto& s : slots_) {
+        bool expected = false;
+        if (!s.in_use.load(std::memory_order_relaxed) &&
+            s.in_use.compare_exchange_strong(expected, true, std::memory_order_acquire)) {
+            return reader(this, &s);
+        }
+    }
+    throw std::length_error("rcu_vector has no free reader slot");
+}
+
+//The slot store and the pointer load are both seq_cst, as are the writer's exchange and its
+//slot scan: either the writer sees this reader in its slot, or this reader sees the new version.
+//
+//The epoch announced may be stale, which only errs on the safe side. A version retired at E is
+//freed only while every announced epoch is at least E. A reader that read an epoch below E
+//keeps it alive whichever pointer it then loads. A reader that read E itself read it from the
+//writer's fetch_add, and the acquire load orders the exchange before it, so the pointer it
+//loads is the replacement or newer, never the retired one.
+template<class T, class Allocator, std::size_t MaxReaders>
+typename rcu_vector<T, Allocator, MaxReaders>::snapshot rcu_vector<T, Allocator, MaxReaders>::enter(slot& s) const noexcept
+{
+    s.epoch.store(epoch_.load(std::memory_order_acquire), std::memory_order_seq_cst);
+    return snapshot(current_.load(std::memory_order_seq_cst), &s.epoch);
+}
+
+template<class T, class Allocator, std::size_t MaxReaders>
+void rcu_vector<T, Allocator, MaxReaders>::publish(version_type next)
+{
+    auto version = new version_type(std::move(next));
+    std::lock_guard<std::mutex> lock(writer_mutex_);
+    publish_locked(version);
+}
+
+template<class T, class Allocator, std::size_t MaxReaders>
+template<class F>
+void rcu_vector<T, Allocator, MaxReaders>::update(F&& edit)
+{
+    std::lock_guard<std::mutex> lock(writer_mutex_);
+    std::unique_ptr<version_type> next(new version_type(*current_.load(std::memory_order_relaxed)));
+    edit(*next);
+    publish_locked(next.release());
+}
+
+template<class T, class Allocator, std::size_t MaxReaders>
+typename rcu_vector<T, Allocator, MaxReaders>::size_type rcu_vector<T, Allocator, MaxReaders>::reclaim()
+{
+    std::lock_guard<std::mutex> lock(writer_mutex_);
+    return reclaim_locked();
+}
+
+template<class T, class Allocator, std::size_t MaxReaders>
+void rcu_vector<T, Allocator, MaxReaders>::synchronize()
+{
+    while (reclaim() != 0) {
+        std::this_thread::yield();
+    }
+}
+
+template<class T, class Allocator, std::size_t MaxReaders>
+typename rcu_vector<T, Allocator, MaxReaders>::size_type rcu_vector<T, Allocator, MaxReaders>::retired() const
+{
+    std::lock_guard<std::mutex> lock(writer_mutex_);
+    return retired_.size();
+}
+
+//Retires the old version under the epoch that readers entering from now on will announce.
+template<class T, class Allocator, std::size_t MaxReaders>
+void rcu_vector<T, Allocator, MaxReaders>::publish_locked(version_type* next)
+{
+    retired_.reserve(retired_.size() + 1);
+    auto old = current_.exchange(next, std::memory_order_seq_cst);
+    auto epoch = epoch_.fetch_add(1, std::memory_order_seq_cst) + 1;
+    retired_.push_back({old, epoch});
+    reclaim_locked();
+}
+
+//A version retired at epoch E may still be in use by a reader whose slot holds a nonzero epoch below E.
+template<class T, class Allocator, std::size_t MaxReaders>
+typename rcu_vector<T, Allocator, MaxReaders>::size_type rcu_vector<T, Allocator, MaxReaders>::reclaim_locked()
+{
+    if (retired_.empty()) {
+        return 0;
+    }
+
+    auto oldest_reader = std::numeric_limits<std::uint64_t>::max();
+    for (auto& s : slots_) {
+        auto epoch = s.epoch.load(std::memory_order_seq_cst);
+        if (epoch != 0 && epoch < oldest_reader) {
+            oldest_reader = epoch;
+        }
+    }
+
+    for (size_type i = 0; i < retired_.size();) {
+        if (retired_[i].epoch <= oldest_reader) {
+            delete retired_[i].version;
+            retired_.unordered_erase(retired_.begin() + i);
+        } else {
+            i++;
+        }
+    }
+    return retired_.size();
+}
+
+} //namespace atl
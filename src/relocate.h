@@ -0,0 +1,81 @@
+#pragma once
+
+#include <memory>
+#include <cstring>
+#include <cstddef>
+#include <type_traits>
+
+namespace atl {
+
+//Types whose objects may be moved to another address with a plain memcpy, the source
+//storage then being treated as already destroyed. Trivially copyable types qualify automatically;
+//specialize for your own types to opt in, e.g.
+//
+//    template <> struct atl::is_trivially_relocatable<Handle> : std::true_type {};
+//
+//for a struct that only holds a std::unique_ptr.
+template <class T>
+struct is_trivially_relocatable : std::is_trivially_copyable<T> {};
+
+template <class T>
+constexpr bool is_trivially_relocatable_v = is_trivially_relocatable<T>::value;
+
+//Moves n elements from first to uninitialized storage at dest and destroys the originals.
+//Bulk memcpy for trivially relocatable types, element-wise move+destroy otherwise.
+template <class Allocator>
+void relocate(Allocator& alloc,
+              typename std::allocator_traits<Allocator>::pointer first,
+              typename std::allocator_traits<Allocator>::size_type n,
+              typename std::allocator_traits<Allocator>::pointer dest)
+{
+    using traits = std::allocator_traits<Allocator>;
+    using T      = typename traits::value_type;
+
+    if (n == 0) {
+        return;
+    }
+
+    if constexpr (is_trivially_relocatable_v<T>) {
+        std::memcpy(static_cast<void*>(std::addressof(*dest)),
+                    static_cast<const void*>(std::addressof(*first)),
+                    n * sizeof(T));
+    } else {
+        for (typename traits::size_type i = 0; i < n; i++) {
+            traits::construct(alloc, std::addressof(*(dest + i)), std::move(*(first + i)));
+            traits::destroy(alloc, std::addressof(*(first + i)));
+        }
+    }
+}
+
+//Like relocate, but [first, first + n) and [dest, dest + n) may overlap.
+template <class Allocator>
+void relocate_overlapping(Allocator& alloc,
+                          typename std::allocator_traits<Allocator>::pointer first,
+                          typename std::allocator_traits<Allocator>::size_type n,
+                          typename std::allocator_traits<Allocator>::pointer dest)
+{
+    using traits = std::allocator_traits<Allocator>;
+    using T      = typename traits::value_type;
+
+    if (n == 0 || first == dest) {
+        return;
+    }
+
+    if constexpr (is_trivially_relocatable_v<T>) {
+        std::memmove(static_cast<void*>(std::addressof(*dest)),
+                     static_cast<const void*>(std::addressof(*first)),
+                     n * sizeof(T));
+    } else if (dest < first) {
+        for (typename traits::size_type i = 0; i < n; i++) {
+            traits::construct(alloc, std::addressof(*(dest + i)), std::move(*(first + i)));
+            traits::destroy(alloc, std::addressof(*(first + i)));
+        }
+    } else {
+        for (auto i = n; i-- > 0;) {
+            traits::construct(alloc, std::addressof(*(dest + i)), std::move(*(first + i)));
+            traits::destroy(alloc, std::addressof(*(first + i)));
+        }
+    }
+}
+
+} //namespace atl
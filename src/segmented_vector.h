@@ -0,0 +1,424 @@
+#pragma once
+
+#include <memory>
+#include <limits>
+#include <cstddef>
+#include <utility>
+#include <iterator>
+#include <stdexcept>
+#include <algorithm>
+#include <type_traits>
+#include <initializer_list>
+#include "indexed_iterator.h"
+
+namespace atl {
+
+namespace detail {
+
+inline std::size_t floor_log2(std::size_t n) noexcept
+{
+#if defined(__GNUC__) || defined(__clang__)
+    return std::numeric_limits<unsigned long long>::digits - 1 - static_cast<std::size_t>(__builtin_clzll(n));
+#else
+    std::size_t result = 0;
+    while (n >>= 1) {
+        result++;
+    }
+    return result;
+#endif
+}
+
+constexpr std::size_t static_log2(std::size_t n) noexcept
+{
+    return n < 2 ? 0 : 1 + static_log2(n / 2);
+}
+
+//Maps element indices onto segments of FirstSegment, 2*FirstSegment, 4*FirstSegment, ...
+//elements, so index arithmetic is one bit scan and a few shifts.
+template <std::size_t FirstSegment>
+struct segment_layout
+{
+    static_assert(FirstSegment > 0 && (FirstSegment & (FirstSegment - 1)) == 0, "FirstSegment must be a power of two");
+
+    static constexpr std::size_t first_bits   = static_log2(FirstSegment);
+    static constexpr std::size_t max_segments = std::numeric_limits<std::size_t>::digits - first_bits;
+
+    static std::size_t segment_of(std::size_t index) noexcept { return floor_log2(index + FirstSegment) - first_bits; }
+    static std::size_t segment_size(std::size_t segment) noexcept { return FirstSegment << segment; }
+    static std::size_t segment_start(std::size_t segment) noexcept { return (FirstSegment << segment) - FirstSegment; }
+    static std::size_t offset_in(std::size_t index, std::size_t segment) noexcept { return index - segment_start(segment); }
+};
+
+} //namespace detail
+
+//Sequence stored in geometrically growing segments that are never moved or freed while the
+//container grows: growth allocates one new segment and copies nothing, and references to
+//elements stay valid until the element is removed. Indexing is O(1) through the segment table.
+template <class T, class Allocator = std::allocator<T>, std::size_t FirstSegment = 16>
+class segmented_vector {
+    using layout = detail::segment_layout<FirstSegment>;
+
+public:
+    // types:
+    using value_type             = T;
+    using reference              = value_type&;
+    using const_reference        = const value_type&;
+    using size_type              = std::size_t;
+    using difference_type        = std::ptrdiff_t;
+
+    using allocator_type         = Allocator;
+    using pointer                = typename std::allocator_traits<Allocator>::pointer;
+    using const_pointer          = typename std::allocator_traits<Allocator>::const_pointer;
+    using iterator               = IndexedIterator<segmented_vector, false>;
+    using const_iterator         = IndexedIterator<segmented_vector, true>;
+    using reverse_iterator       = std::reverse_iterator<iterator>;
+    using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+    // construct/copy/destroy:
+    explicit segmented_vector(const Allocator& alloc = Allocator()) noexcept;
+    segmented_vector(size_type size, const T& value, const Allocator& alloc = Allocator());
+
+    template <class InputIterator, class = typename std::iterator_traits<InputIterator>::iterator_category>
+    segmented_vector(InputIterator first, InputIterator last, const Allocator& alloc = Allocator());
+
+    segmented_vector(std::initializer_list<T> ilist, const Allocator& alloc = Allocator());
+    segmented_vector(const segmented_vector& other);
+    segmented_vector(segmented_vector&& other) noexcept;
+    ~segmented_vector();
+
+    segmented_vector& operator=(const segmented_vector& rhs);
+    segmented_vector& operator=(segmented_vector&& rhs) noexcept(std::allocator_traits<Allocator>::propagate_on_container_move_assignment::value ||
+                                                                 std::allocator_traits<Allocator>::is_always_equal::value);
+
+    allocator_type get_allocator() const noexcept { return allocator_; }
+
+    // iterators:
+    iterator                begin() noexcept         { return iterator(this, 0); }
+    const_iterator          begin() const noexcept   { return const_iterator(this, 0); }
+    iterator                end() noexcept           { return iterator(this, size_); }
+    const_iterator          end() const noexcept     { return const_iterator(this, size_); }
+    const_iterator          cbegin() const noexcept  { return begin(); }
+    const_iterator          cend() const noexcept    { return end(); }
+
+    reverse_iterator        rbegin() noexcept        { return reverse_iterator(end()); }
+    const_reverse_iterator  rbegin() const noexcept  { return const_reverse_iterator(end()); }
+    reverse_iterator        rend() noexcept          { return reverse_iterator(begin()); }
+    const_reverse_iterator  rend() const noexcept    { return const_reverse_iterator(begin()); }
+
+    // capacity:
+    size_type size() const noexcept     { return size_; }
+    size_type capacity() const noexcept { return layout::segment_start(segment_count_); }
+    bool      empty() const noexcept    { return size_ == 0; }
+    void      reserve(size_type capacity);
+    void      shrink_to_fit();
+    void      resize(size_type new_size);
+    void      resize(size_type new_size, const T& elem);
+
+    size_type segment_count() const noexcept { return segment_count_; }
+
+    // element access:
+    reference       operator[](size_type n)       { return *element(n); }
+    const_reference operator[](size_type n) const { return *element(n); }
+    reference       at(size_type pos);
+    const_reference at(size_type pos) const;
+    reference       front()       { return *element(0); }
+    const_reference front() const { return *element(0); }
+    reference       back()        { return *element(size_ - 1); }
+    const_reference back() const  { return *element(size_ - 1); }
+
+    // modifiers:
+    template <class... Args> reference emplace_back(Args&& ...args);
+    void push_back(const T& elem);
+    void push_back(T&& elem);
+    void pop_back();
+    void swap(segmented_vector&) noexcept;
+    void clear() noexcept;
+
+private:
+    Allocator allocator_;
+    pointer segments_[layout::max_segments];
+    size_type segment_count_;
+    size_type size_;
+
+    pointer element(size_type index) const noexcept;
+    void add_segment();
+    void release() noexcept;
+    void swap_storage(segmented_vector& other) noexcept;
+};
+
+template<class T, class Allocator, std::size_t FirstSegment>
+segmented_vector<T, Allocator, FirstSegment>::segmented_vector(const Allocator& alloc) noexcept
+        : allocator_(alloc),
+          segments_(),
+          segment_count_(0),
+          size_(0) {}
+
+template<class T, class Allocator, std::size_t FirstSegment>
+segmented_vector<T, Allocator, FirstSegment>::segmented_vector(size_type size, const T& value, const Allocator& alloc)
+        : segmented_vector(alloc)
+{
+    resize(size, value);
+}
+
+template<class T, class Allocator, std::size_t FirstSegment>
+template<class InputIterator, class>
+segmented_vector<T, Allocator, FirstSegment>::segmented_vector(InputIterator first, InputIterator last, const Allocator& alloc)
+        : segmented_vector(alloc)
+{
+    for (; first != last; ++first) {
+        emplace_back(*first);
+    }
+}
+
+template<class T, class Allocator, std::size_t FirstSegment>
+segmented_vector<T, Allocator, FirstSegment>::segmented_vector(std::initializer_list<T> ilist, const Allocator& alloc)
+        : segmented_vector(ilist.begin(), ilist.end(), alloc) {}
+
+template<class T, class Allocator, std::size_t FirstSegment>
+segmented_vector<T, Allocator, FirstSegment>::segmented_vector(const segmented_vector& other)
+        : segmented_vector(std::allocator_traits<Allocator>::select_on_container_copy_construction(other.allocator_))
+{
+    reserve(other.size_);
+    for (const auto& elem : other) {
+        emplace_back(elem);
+    }
+}
+
+template<class T, class Allocator, std::size_t FirstSegment>
+segmented_vector<T, Allocator, FirstSegment>::segmented_vector(segmented_vector&& other) noexcept
+        : segmented_vector(std::move(other.allocator_))
+{
+    swap_storage(other);
+}
+
+template<class T, class Allocator, std::size_t FirstSegment>
+segmented_vector<T, Allocator, FirstSegment>::~segmented_vector()
+{
+    release();
+}
+
+template<class T, class Allocator, std::size_t FirstSegment>
+segmented_vector<T, Allocator, FirstSegment>& segmented_vector<T, Allocator, FirstSegment>::operator=(const segmented_vector& rhs)
+{
+    if (this == &rhs) {
+        return *this;
+    }
+
+    if constexpr (std::allocator_traits<Allocator>::propagate_on_container_copy_assignment::value) {
+        if (!(allocator_ == rhs.allocator_)) {
+            release();
+        }
+        allocator_ = rhs.allocator_;
+    }
+
+    clear();
+    reserve(rhs.size_);
+    for (const auto& elem : rhs) {
+        emplace_back(elem);
+    }
+    return *this;
+}
+
+template<class T, class Allocator, std::size_t FirstSegment>
+segmented_vector<T, Allocator, FirstSegment>& segmented_vector<T, Allocator, FirstSegment>::operator=(segmented_vector&& rhs)
+        noexcept(std::allocator_traits<Allocator>::propagate_on_container_move_assignment::value ||
+                 std::allocator_traits<Allocator>::is_always_equal::value)
+{
+    if (this == &rhs) {
+        return *this;
+    }
+
+    if constexpr (!std::allocator_traits<Allocator>::propagate_on_container_move_assignment::value) {
+        if (!(allocator_ == rhs.allocator_)) {
+            clear();
+            reserve(rhs.size_);
+            for (auto& elem : rhs) {
+                emplace_back(std::move(elem));
+            }
+            rhs.clear();
+            return *this;
+        }
+    }
+
+    release();
+    if constexpr (std::allocator_traits<Allocator>::propagate_on_container_move_assignment::value) {
+        allocator_ = std::move(rhs.allocator_);
+    }
+    swap_storage(rhs);
+    return *this;
+}
+
+template<class T, class Allocator, std::size_t FirstSegment>
+void segmented_vector<T, Allocator, FirstSegment>::reserve(size_type capacity)
+{
+    while (this->capacity() < capacity) {
+        add_segment();
+    }
+}
+
+//Frees the segments past the one holding the last element.
+template<class T, class Allocator, std::size_t FirstSegment>
+void segmented_vector<T, Allocator, FirstSegment>::shrink_to_fit()
+{
+    auto needed = size_ == 0 ? 0 : layout::segment_of(size_ - 1) + 1;
+    while (segment_count_ > needed) {
+        --segment_count_;
+        std::allocator_traits<Allocator>::deallocate(allocator_, segments_[segment_count_], layout::segment_size(segment_count_));
+        segments_[segment_count_] = nullptr;
+    }
+}
+
+template<class T, class Allocator, std::size_t FirstSegment>
+void segmented_vector<T, Allocator, FirstSegment>::resize(size_type new_size)
+{
+    while (size_ > new_size) {
+        pop_back();
+    }
+    reserve(new_size);
+    while (size_ < new_size) {
+        emplace_back();
+    }
+}
+
+template<class T, class Allocator, std::size_t FirstSegment>
+void segmented_vector<T, Allocator, FirstSegment>::resize(size_type new_size, const T& elem)
+{
+    while (size_ > new_size) {
+        pop_back();
+    }
+    reserve(new_size);
+    while (size_ < new_size) {
+        emplace_back(elem);
+    }
+}
+
+template<class T, class Allocator, std::size_t FirstSegment>
+typename segmented_vector<T, Allocator, FirstSegment>::reference segmented_vector<T, Allocator, FirstSegment>::at(size_type pos)
+{
+    if (size_ <= pos) {
+        throw std::out_of_range("Index out of range");
+    }
+    return *element(pos);
+}
+
+template<class T, class Allocator, std::size_t FirstSegment>
+typename segmented_vector<T, Allocator, FirstSegment>::const_reference segmented_vector<T, Allocator, FirstSegment>::at(size_type pos) const
+{
+    if (size_ <= pos) {
+        throw std::out_of_range("Index out of range");
+    }
+    return *element(pos);
+}
+
+template<class T, class Allocator, std::size_t FirstSegment>
+template<class... Args>
+typename segmented_vector<T, Allocator, FirstSegment>::reference segmented_vector<T, Allocator, FirstSegment>::emplace_back(Args&& ...args)
+{
+    if (size_ == capacity()) {
+        add_segment();
+    }
+
+    auto slot = element(size_);
+    std::allocator_traits<Allocator>::construct(allocator_, std::addressof(*slot), std::forward<Args>(args)...);
+    ++size_;
+    return *slot;
+}
+
+template<class T, class Allocator, std::size_t FirstSegment>
+void segmented_vector<T, Allocator, FirstSegment>::push_back(const T& elem)
+{
+    emplace_back(elem);
+}
+
+template<class T, class Allocator, std::size_t FirstSegment>
+void segmented_vector<T, Allocator, FirstSegment>::push_back(T&& elem)
+{
+    emplace_back(std::move(elem));
+}
+
+template<class T, class Allocator, std::size_t FirstSegment>
+void segmented_vector<T, Allocator, FirstSegment>::pop_back()
+{
+    if (size_ > 0) {
+        --size_;
+        std::allocator_traits<Allocator>::destroy(allocator_, std::addressof(*element(size_)));
+    }
+}
+
+template<class T, class Allocator, std::size_t FirstSegment>
+void segmented_vector<T, Allocator, FirstSegment>::swap(segmented_vector& other) noexcept
+{
+    if constexpr (std::allocator_traits<Allocator>::propagate_on_container_swap::value) {
+        using std::swap;
+        swap(allocator_, other.allocator_);
+    }
+    swap_storage(other);
+}
+
+template<class T, class Allocator, std::size_t FirstSegment>
+void segmented_vector<T, Allocator, FirstSegment>::clear() noexcept
+{
+    //walk segment by segment rather than paying the index mapping per element
+    size_type remaining = size_;
+    for (size_type segment = 0; remaining > 0; segment++) {
+        auto count = std::min(remaining, layout::segment_size(segment));
+        for (size_type i = 0; i < count; i++) {
+            std::allocator_traits<Allocator>::destroy(allocator_, std::addressof(*(segments_[segment] + i)));
+        }
+        remaining -= count;
+    }
+    size_ = 0;
+}
+
+template<class T, class Allocator, std::size_t FirstSegment>
+typename segmented_vector<T, Allocator, FirstSegment>::pointer segmented_vector<T, Allocator, FirstSegment>::element(size_type index) const noexcept
+{
+    auto segment = layout::segment_of(index);
+    return segments_[segment] + layout::offset_in(index, segment);
+}
+
+template<class T, class Allocator, std::size_t FirstSegment>
+void segmented_vector<T, Allocator, FirstSegment>::add_segment()
+{
+    if (segment_count_ == layout::max_segments) {
+        throw std::length_error("segmented_vector is full");
+    }
+
+    segments_[segment_count_] = std::allocator_traits<Allocator>::allocate(allocator_, layout::segment_size(segment_count_));
+    ++segment_count_;
+}
+
+template<class T, class Allocator, std::size_t FirstSegment>
+void segmented_vector<T, Allocator, FirstSegment>::release() noexcept
+{
+    clear();
+    shrink_to_fit();
+}
+
+template<class T, class Allocator, std::size_t FirstSegment>
+void segmented_vector<T, Allocator, FirstSegment>::swap_storage(segmented_vector& other) noexcept
+{
+    std::swap(segments_, other.segments_);
+    std::swap(segment_count_, other.segment_count_);
+    std::swap(size_, other.size_);
+}
+
+template <class T, class Allocator, std::size_t FirstSegment>
+bool operator==(const segmented_vector<T, Allocator, FirstSegment>& lhs, const segmented_vector<T, Allocator, FirstSegment>& rhs)
+{
+    return lhs.size() == rhs.size() && std::equal(lhs.begin(), lhs.end(), rhs.begin());
+}
+
+template <class T, class Allocator, std::size_t FirstSegment>
+bool operator!=(const segmented_vector<T, Allocator, FirstSegment>& lhs, const segmented_vector<T, Allocator, FirstSegment>& rhs)
+{
+    return !(lhs == rhs);
+}
+
+template <class T, class Allocator, std::size_t FirstSegment>
+void swap(segmented_vector<T, Allocator, FirstSegment>& lhs, segmented_vector<T, Allocator, FirstSegment>& rhs) noexcept
+{
+    lhs.swap(rhs);
+}
+
+} //namespace atl
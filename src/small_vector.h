@@ -0,0 +1,426 @@
+#pragma once
+
+#include <memory>
+#include <cstddef>
+#include <utility>
+#include <iterator>
+#include <type_traits>
+#include <initializer_list>
+#include "vector.h"
+
+namespace atl {
+
+namespace detail {
+
+//Allocator handing out the inline buffer of a small_vector while it is free and the request
+//fits, forwarding everything else to the upstream allocator.
+template <class T, std::size_t N, class Allocator>
+class inline_buffer_allocator
+{
+public:
+    using value_type      = T;
+    using size_type       = std::size_t;
+    using difference_type = std::ptrdiff_t;
+
+    //the buffer lives inside the container, so the allocator never travels with its elements
+    using propagate_on_container_copy_assignment = std::false_type;
+    using propagate_on_container_move_assignment = std::false_type;
+    using propagate_on_container_swap            = std::false_type;
+    using is_always_equal                        = std::false_type;
+
+    template <class U>
+    struct rebind {
+        using other = inline_buffer_allocator<U, N, typename std::allocator_traits<Allocator>::template rebind_alloc<U>>;
+    };
+
+    inline_buffer_allocator(T* buffer, const Allocator& upstream) noexcept
+            : upstream_(upstream), buffer_(buffer), in_use_(false) {}
+
+    //rebound copies have no inline buffer of their own
+    template <class U, class UAllocator>
+    inline_buffer_allocator(const inline_buffer_allocator<U, N, UAllocator>& other) noexcept
+            : upstream_(other.upstream()), buffer_(nullptr), in_use_(false) {}
+
+    T* allocate(size_type n);
+    allocation_result<T*> allocate_at_least(size_type n);
+    //hands out the inline buffer, which must be free; never allocates
+    allocation_result<T*> take_inline_buffer() noexcept;
+    void deallocate(T* p, size_type n) noexcept;
+
+    template <class A = Allocator, class = std::enable_if_t<has_reallocate_v<A>>>
+    allocation_result<T*> reallocate(T* p, size_type old_n, size_type new_n) noexcept;
+
+    template <class U, class... Args>
+    void construct(U* p, Args&&... args)
+    {
+        std::allocator_traits<Allocator>::construct(upstream_, p, std::forward<Args>(args)...);
+    }
+
+    template <class U>
+    void destroy(U* p)
+    {
+        std::allocator_traits<Allocator>::destroy(upstream_, p);
+    }
+
+    size_type max_size() const noexcept { return std::allocator_traits<Allocator>::max_size(upstream_); }
+
+    inline_buffer_allocator select_on_container_copy_construction() const
+    {
+        return inline_buffer_allocator(nullptr, std::allocator_traits<Allocator>::select_on_container_copy_construction(upstream_));
+    }
+
+    const Allocator& upstream() const noexcept { return upstream_; }
+
+    friend bool operator==(const inline_buffer_allocator& lhs, const inline_buffer_allocator& rhs) noexcept
+    {
+        return lhs.buffer_ == rhs.buffer_ && lhs.upstream_ == rhs.upstream_;
+    }
+
+    friend bool operator!=(const inline_buffer_allocator& lhs, const inline_buffer_allocator& rhs) noexcept
+    {
+        return !(lhs == rhs);
+    }
+
+private:
+    Allocator upstream_;
+    T* buffer_;
+    bool in_use_;
+};
+
+template<class T, std::size_t N, class Allocator>
+T* inline_buffer_allocator<T, N, Allocator>::allocate(size_type n)
+{
+    return allocate_at_least(n).ptr;
+}
+
+template<class T, std::size_t N, class Allocator>
+allocation_result<T*> inline_buffer_allocator<T, N, Allocator>::allocate_at_least(size_type n)
+{
+    if (buffer_ != nullptr && !in_use_ && n <= N) {
+        in_use_ = true;
+        return {buffer_, N};
+    }
+
+    auto result = atl::allocate_at_least(upstream_, n);
+    return {std::addressof(*result.ptr), result.count};
+}
+
+template<class T, std::size_t N, class Allocator>
+allocation_result<T*> inline_buffer_allocator<T, N, Allocator>::take_inline_buffer() noexcept
+{
+    in_use_ = true;
+    return {buffer_, N};
+}
+
+template<class T, std::size_t N, class Allocator>
+void inline_buffer_allocator<T, N, Allocator>::deallocate(T* p, size_type n) noexcept
+{
+    if (p == buffer_) {
+        in_use_ = false;
+        return;
+    }
+    std::allocator_traits<Allocator>::deallocate(upstream_, p, n);
+}
+
+template<class T, std::size_t N, class Allocator>
+template<class A, class>
+allocation_result<T*> inline_buffer_allocator<T, N, Allocator>::reallocate(T* p, size_type old_n, size_type new_n) noexcept
+{
+    //moving into or out of the inline buffer is up to the container's copy path
+    if (p == buffer_ || (new_n <= N && buffer_ != nullptr && !in_use_)) {
+        return {nullptr, 0};
+    }
+    auto result = atl::reallocate_at_least(upstream_, p, old_n, new_n);
+    return {result.ptr == nullptr ? nullptr : std::addressof(*result.ptr), result.count};
+}
+
+//Keeps the first allocation inside the inline buffer and defers to GrowthPolicy beyond it.
+template <class GrowthPolicy, std::size_t N>
+struct inline_growth_policy
+{
+    static constexpr std::size_t min_capacity   = N;
+    static constexpr bool        allocate_empty = true;
+
+    static constexpr std::size_t next_capacity(std::size_t capacity, std::size_t required) noexcept
+    {
+        return required <= N ? N : GrowthPolicy::next_capacity(capacity, required);
+    }
+
+    static constexpr std::size_t round_capacity(std::size_t n, std::size_t elem_size) noexcept
+    {
+        return n <= N ? n : GrowthPolicy::round_capacity(n, elem_size);
+    }
+};
+
+} //namespace detail
+
+//Vector with inline storage for N elements, spilling to the heap only once it outgrows them.
+//All modifiers are atl::vector's; only copying, moving, swapping and shrink_to_fit know about
+//the inline buffer. Move assignment can only avoid allocating when the upstream allocators are
+//always equal, so only then is it noexcept; swap never allocates.
+template <class T, std::size_t N, class Allocator = std::allocator<T>, class GrowthPolicy = default_growth_policy>
+class small_vector : public vector<T,
+                                   detail::inline_buffer_allocator<T, N, Allocator>,
+                                   detail::inline_growth_policy<GrowthPolicy, N>>
+{
+    static_assert(N > 0, "small_vector: inline capacity must be positive");
+
+    using base = vector<T, detail::inline_buffer_allocator<T, N, Allocator>, detail::inline_growth_policy<GrowthPolicy, N>>;
+
+public:
+    using allocator_type  = Allocator;
+    using size_type       = typename base::size_type;
+    using value_type      = typename base::value_type;
+
+    static constexpr size_type inline_capacity = N;
+
+    explicit small_vector(const Allocator& alloc = Allocator());
+    explicit small_vector(size_type size);
+    small_vector(size_type size, const T& value, const Allocator& alloc = Allocator());
+
+    template <class InputIterator, class = typename std::iterator_traits<InputIterator>::iterator_category>
+    small_vector(InputIterator first, InputIterator last, const Allocator& alloc = Allocator());
+
+    small_vector(std::initializer_list<T> ilist, const Allocator& alloc = Allocator());
+
+    small_vector(const small_vector& other);
+    small_vector(small_vector&& other) noexcept(std::is_nothrow_move_constructible<T>::value);
+
+    small_vector& operator=(const small_vector& rhs);
+    small_vector& operator=(small_vector&& rhs) noexcept(std::allocator_traits<Allocator>::is_always_equal::value &&
+                                                         std::is_nothrow_move_constructible<T>::value);
+    small_vector& operator=(std::initializer_list<T> ilist);
+
+    void swap(small_vector& other) noexcept(std::is_nothrow_move_constructible<T>::value);
+
+    //moves the elements back into the inline buffer once they fit; a no-op while inline
+    void shrink_to_fit();
+
+    allocator_type get_allocator() const noexcept;
+
+    //true while the elements live in the inline buffer
+    bool is_inline() const noexcept;
+
+private:
+    alignas(T) unsigned char storage_[N * sizeof(T)];
+
+    T* inline_data() noexcept;
+    void take_heap_buffer(small_vector& other) noexcept;
+    void relocate_from(small_vector& other) noexcept(std::is_nothrow_move_constructible<T>::value);
+};
+
+template<class T, std::size_t N, class Allocator, class GrowthPolicy>
+small_vector<T, N, Allocator, GrowthPolicy>::small_vector(const Allocator& alloc)
+        : base(typename base::allocator_type(inline_data(), alloc)) {}
+
+template<class T, std::size_t N, class Allocator, class GrowthPolicy>
+small_vector<T, N, Allocator, GrowthPolicy>::small_vector(size_type size)
+        : small_vector()
+{
+    this->resize(size);
+}
+
+template<class T, std::size_t N, class Allocator, class GrowthPolicy>
+small_vector<T, N, Allocator, GrowthPolicy>::small_vector(size_type size, const T& value, const Allocator& alloc)
+        : small_vector(alloc)
+{
+    this->resize(size, value);
+}
+
+template<class T, std::size_t N, class Allocator, class GrowthPolicy>
+template<class InputIterator, class>
+small_vector<T, N, Allocator, GrowthPolicy>::small_vector(InputIterator first, InputIterator last, const Allocator& alloc)
+        : small_vector(alloc)
+{
+    this->assign(first, last);
+}
+
+template<class T, std::size_t N, class Allocator, class GrowthPolicy>
+small_vector<T, N, Allocator, GrowthPolicy>::small_vector(std::initializer_list<T> ilist, const Allocator& alloc)
+        : small_vector(alloc)
+{
+    this->assign(ilist.begin(), ilist.end());
+}
+
+template<class T, std::size_t N, class Allocator, class GrowthPolicy>
+small_vector<T, N, Allocator, GrowthPolicy>::small_vector(const small_vector& other)
+        : small_vector(std::allocator_traits<Allocator>::select_on_container_copy_construction(other.get_allocator()))
+{
+    this->assign(other.begin(), other.end());
+}
+
+template<class T, std::size_t N, class Allocator, class GrowthPolicy>
+small_vector<T, N, Allocator, GrowthPolicy>::small_vector(small_vector&& other)
+        noexcept(std::is_nothrow_move_constructible<T>::value)
+        : small_vector(other.get_allocator())
+{
+    if (other.is_inline()) {
+        relocate_from(other);
+    } else {
+        take_heap_buffer(other);
+    }
+}
+
+template<class T, std::size_t N, class Allocator, class GrowthPolicy>
+small_vector<T, N, Allocator, GrowthPolicy>& small_vector<T, N, Allocator, GrowthPolicy>::operator=(const small_vector& rhs)
+{
+    if (this != &rhs) {
+        this->assign(rhs.begin(), rhs.end());
+    }
+    return *this;
+}
+
+template<class T, std::size_t N, class Allocator, class GrowthPolicy>
+small_vector<T, N, Allocator, GrowthPolicy>& small_vector<T, N, Allocator, GrowthPolicy>::operator=(small_vector&& rhs)
+        noexcept(std::allocator_traits<Allocator>::is_always_equal::value && std::is_nothrow_move_constructible<T>::value)
+{
+    if (this == &rhs) {
+        return *this;
+    }
+
+    this->clear();
+
+    //capacity is never below N, so with equal allocators neither branch allocates
+    if (!rhs.is_inline() && get_allocator() == rhs.get_allocator()) {
+        take_heap_buffer(rhs);
+    } else if (rhs.size_ <= this->capacity_) {
+        relocate_from(rhs);
+    } else {
+        this->assign(std::make_move_iterator(rhs.begin()), std::make_move_iterator(rhs.end()));
+        rhs.clear();
+    }
+
+    return *this;
+}
+
+template<class T, std::size_t N, class Allocator, class GrowthPolicy>
+small_vector<T, N, Allocator, GrowthPolicy>& small_vector<T, N, Allocator, GrowthPolicy>::operator=(std::initializer_list<T> ilist)
+{
+    this->assign(ilist.begin(), ilist.end());
+    return *this;
+}
+
+template<class T, std::size_t N, class Allocator, class GrowthPolicy>
+void small_vector<T, N, Allocator, GrowthPolicy>::swap(small_vector& other)
+        noexcept(std::is_nothrow_move_constructible<T>::value)
+{
+    if (this == &other) {
+        return;
+    }
+
+    //both on the heap: exchange buffers
+    if (!is_inline() && !other.is_inline()) {
+        this->swap_storage(other);
+        return;
+    }
+
+    //both inline: swap the common prefix, relocate the longer tail
+    if (is_inline() && other.is_inline()) {
+        auto& longer  = this->size_ >= other.size_ ? *this : other;
+        auto& shorter = this->size_ >= other.size_ ? other : *this;
+
+        for (size_type i = 0; i < shorter.size_; i++) {
+            using std::swap;
+            swap(longer.data_[i], shorter.data_[i]);
+        }
+        atl::relocate(shorter.allocator_, longer.data_ + shorter.size_, longer.size_ - shorter.size_,
+                      shorter.data_ + shorter.size_);
+        std::swap(longer.size_, shorter.size_);
+        return;
+    }
+
+    //mixed: the inline elements move into the other buffer, the heap buffer changes owner
+    auto& heap_side   = is_inline() ? other : *this;
+    auto& inline_side = is_inline() ? *this : other;
+
+    auto heap_data     = heap_side.data_;
+    auto heap_size     = heap_side.size_;
+    auto heap_capacity = heap_side.capacity_;
+
+    auto allocation = heap_side.allocator_.take_inline_buffer();
+    heap_side.data_     = allocation.ptr;
+    heap_side.capacity_ = allocation.count;
+    heap_side.size_     = 0;
+    heap_side.relocate_from(inline_side);
+
+    inline_side.allocator_.deallocate(inline_side.data_, inline_side.capacity_);
+    inline_side.data_     = heap_data;
+    inline_side.size_     = heap_size;
+    inline_side.capacity_ = heap_capacity;
+}
+
+//vector::shrink_to_fit would ask for exactly size() elements, which the busy inline buffer
+//cannot provide, and so move inline elements out to the heap
+template<class T, std::size_t N, class Allocator, class GrowthPolicy>
+void small_vector<T, N, Allocator, GrowthPolicy>::shrink_to_fit()
+{
+    if (is_inline()) {
+        return;
+    }
+    if (this->size_ > N) {
+        base::shrink_to_fit();
+        return;
+    }
+
+    auto heap_data     = this->data_;
+    auto heap_capacity = this->capacity_;
+    auto allocation    = this->allocator_.take_inline_buffer();
+    atl::relocate(this->allocator_, heap_data, this->size_, allocation.ptr);
+    this->allocator_.deallocate(heap_data, heap_capacity);
+    this->data_     = allocation.ptr;
+    this->capacity_ = allocation.count;
+}
+
+template<class T, std::size_t N, class Allocator, class GrowthPolicy>
+typename small_vector<T, N, Allocator, GrowthPolicy>::allocator_type small_vector<T, N, Allocator, GrowthPolicy>::get_allocator() const noexcept
+{
+    return this->allocator_.upstream();
+}
+
+template<class T, std::size_t N, class Allocator, class GrowthPolicy>
+bool small_vector<T, N, Allocator, GrowthPolicy>::is_inline() const noexcept
+{
+    return this->data_ == reinterpret_cast<const T*>(storage_);
+}
+
+template<class T, std::size_t N, class Allocator, class GrowthPolicy>
+T* small_vector<T, N, Allocator, GrowthPolicy>::inline_data() noexcept
+{
+    return reinterpret_cast<T*>(storage_);
+}
+
+//*this must be empty; other must be on the heap and use an equal upstream allocator
+template<class T, std::size_t N, class Allocator, class GrowthPolicy>
+void small_vector<T, N, Allocator, GrowthPolicy>::take_heap_buffer(small_vector& other) noexcept
+{
+    if (this->data_ != nullptr) {
+        this->allocator_.deallocate(this->data_, this->capacity_);
+    }
+    this->data_     = other.data_;
+    this->size_     = other.size_;
+    this->capacity_ = other.capacity_;
+
+    auto allocation = other.allocator_.take_inline_buffer();
+    other.data_     = allocation.ptr;
+    other.size_     = 0;
+    other.capacity_ = allocation.count;
+}
+
+//*this must be empty with room for other's elements; leaves other empty
+template<class T, std::size_t N, class Allocator, class GrowthPolicy>
+void small_vector<T, N, Allocator, GrowthPolicy>::relocate_from(small_vector& other)
+        noexcept(std::is_nothrow_move_constructible<T>::value)
+{
+    atl::relocate(this->allocator_, other.data_, other.size_, this->data_);
+    this->size_ = other.size_;
+    other.size_ = 0;
+}
+
+template <class T, std::size_t N, class Allocator, class GrowthPolicy>
+void swap(small_vector<T, N, Allocator, GrowthPolicy>& lhs, small_vector<T, N, Allocator, GrowthPolicy>& rhs)
+        noexcept(noexcept(lhs.swap(rhs)))
+{
+    lhs.swap(rhs);
+}
+
+} //namespace atl
@@ -0,0 +1,200 @@
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <cstddef>
+#include <limits>
+#include <stdexcept>
+#include <utility>
+#include <iterator>
+#include <type_traits>
+#include <algorithm>
+#include "vector.h"
+#include "cache_line.h"
+
+namespace atl {
+
+//Bounded queue between exactly one producer thread and one consumer thread. The slots are an
+//atl::vector of power-of-two size allocated once in the constructor, so the ring never allocates
+//afterwards; elements are copied or moved into and out of live slots by assignment, which makes
+//a batch at most two contiguous std::copy/std::move calls (memmove for trivially copyable T).
+//
+//The producer owns the write index and the consumer the read index, each on its own cache line
+//next to the owner's cached copy of the other index, so the lines only change hands when a
+//side actually runs out of room or data.
+template <class T, class Allocator = std::allocator<T>>
+class spsc_ring {
+public:
+    using value_type     = T;
+    using size_type      = std::size_t;
+    using allocator_type = Allocator;
+
+    //capacity is rounded up to a power of two
+    explicit spsc_ring(size_type capacity, const Allocator& alloc = Allocator());
+    spsc_ring(const spsc_ring&) = delete;
+    spsc_ring& operator=(const spsc_ring&) = delete;
+
+    size_type capacity() const noexcept { return mask_ + 1; }
+    //exact only when called from the producer or consumer while the other side is idle
+    size_type size() const noexcept;
+    bool      empty() const noexcept { return size() == 0; }
+
+    // producer side:
+    bool try_push(const T& elem) { return push_one(elem); }
+    bool try_push(T&& elem)      { return push_one(std::move(elem)); }
+    //copies up to n elements from first, returns how many fit
+    template <class InputIterator>
+    size_type push_n(InputIterator first, size_type n);
+
+    // consumer side:
+    bool try_pop(T& out);
+    //moves up to n elements to out, returns how many were available
+    template <class OutputIterator>
+    size_type pop_n(OutputIterator out, size_type n);
+
+private:
+    atl::vector<T, Allocator> slots_;
+    size_type mask_;
+
+    alignas(cache_line_size) std::atomic<size_type> write_;
+    size_type read_cache_;
+
+    alignas(cache_line_size) std::atomic<size_type> read_;
+    size_type write_cache_;
+
+    size_type free_slots(size_type write, size_type wanted);
+    size_type filled_slots(size_type read, size_type wanted);
+    template <class U> bool push_one(U&& elem);
+};
+
+namespace detail {
+
+inline std::size_t round_up_to_power_of_two(std::size_t n)
+{
+    constexpr std::size_t largest = (std::numeric_limits<std::size_t>::max() >> 1) + 1;
+    if (n > largest) {
+        throw std::length_error("spsc_ring: capacity above the largest power of two");
+    }
+
+    std::size_t result = 1;
+    while (result < n) {
+        result <<= 1;
+    }
+    return result;
+}
+
+} //namespace detail
+
+template<class T, class Allocator>
+spsc_ring<T, Allocator>::spsc_ring(size_type capacity, const Allocator& alloc)
+        : slots_(detail::round_up_to_power_of_two(std::max<size_type>(capacity, 1)), alloc),
+          mask_(slots_.size() - 1),
+          write_(0),
+          read_cache_(0),
+          read_(0),
+          write_cache_(0) {}
+
+template<class T, class Allocator>
+typename spsc_ring<T, Allocator>::size_type spsc_ring<T, Allocator>::size() const noexcept
+{
+    auto read = read_.load(std::memory_order_acquire);
+    return write_.load(std::memory_order_acquire) - read;
+}
+
+template<class T, class Allocator>
+template<class InputIterator>
+typename spsc_ring<T, Allocator>::size_type spsc_ring<T, Allocator>::push_n(InputIterator first, size_type n)
+{
+    auto write = write_.load(std::memory_order_relaxed);
+    n = std::min(n, free_slots(write, n));
+    if (n == 0) {
+        return 0;
+    }
+
+    auto start = write & mask_;
+    auto head  = std::min(n, capacity() - start);
+    auto slots = slots_.data();
+    if constexpr (std::is_base_of<std::random_access_iterator_tag, typename std::iterator_traits<InputIterator>::iterator_category>::value) {
+        std::copy(first, first + head, slots + start);
+        std::copy(first + head, first + n, slots);
+    } else {
+        for (size_type i = 0; i < n; i++, ++first) {
+            slots[(start + i) & mask_] = *first;
+        }
+    }
+
+    write_.store(write + n, std::memory_order_release);
+    return n;
+}
+
+template<class T, class Allocator>
+bool spsc_ring<T, Allocator>::try_pop(T& out)
+{
+    auto read = read_.load(std::memory_order_relaxed);
+    if (filled_slots(read, 1) == 0) {
+        return false;
+    }
+
+    out = std::move(slots_[read & mask_]);
+    read_.store(read + 1, std::memory_order_release);
+    return true;
+}
+
+template<class T, class Allocator>
+template<class OutputIterator>
+typename spsc_ring<T, Allocator>::size_type spsc_ring<T, Allocator>::pop_n(OutputIterator out, size_type n)
+{
+    auto read = read_.load(std::memory_order_relaxed);
+    n = std::min(n, filled_slots(read, n));
+    if (n == 0) {
+        return 0;
+    }
+
+    auto start = read & mask_;
+    auto head  = std::min(n, capacity() - start);
+    auto slots = slots_.data();
+    out = std::move(slots + start, slots + start + head, out);
+    std::move(slots, slots + (n - head), out);
+
+    read_.store(read + n, std::memory_order_release);
+    return n;
+}
+
+//Free slots as seen by the producer; rereads the consumer's index only when the cached copy falls short.
+template<class T, class Allocator>
+typename spsc_ring<T, Allocator>::size_type spsc_ring<T, Allocator>::free_slots(size_type write, size_type wanted)
+{
+    auto free = capacity() - (write - read_cache_);
+    if (free < wanted) {
+        read_cache_ = read_.load(std::memory_order_acquire);
+        free = capacity() - (write - read_cache_);
+    }
+    return free;
+}
+
+template<class T, class Allocator>
+typename spsc_ring<T, Allocator>::size_type spsc_ring<T, Allocator>::filled_slots(size_type read, size_type wanted)
+{
+    auto filled = write_cache_ - read;
+    if (filled < wanted) {
+        write_cache_ = write_.load(std::memory_order_acquire);
+        filled = write_cache_ - read;
+    }
+    return filled;
+}
+
+template<class T, class Allocator>
+template<class U>
+bool spsc_ring<T, Allocator>::push_one(U&& elem)
+{
+    auto write = write_.load(std::memory_order_relaxed);
+    if (free_slots(write, 1) == 0) {
+        return false;
+    }
+
+    slots_[write & mask_] = std::forward<U>(elem);
+    write_.store(write + 1, std::memory_order_release);
+    return true;
+}
+
+} //namespace atl
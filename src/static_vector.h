@@ -0,0 +1,545 @@
+#pragma once
+
+#include <new>
+#include <memory>
+#include <cstdint>
+#include <cstddef>
+#include <utility>
+#include <iterator>
+#include <algorithm>
+#include <stdexcept>
+#include <type_traits>
+#include <initializer_list>
+
+namespace atl {
+
+namespace detail {
+
+//smallest unsigned integer type able to represent N
+template <std::size_t N>
+using smallest_size_t = std::conditional_t<N <= UINT8_MAX, std::uint8_t,
+                        std::conditional_t<N <= UINT16_MAX, std::uint16_t,
+                        std::conditional_t<N <= UINT32_MAX, std::uint32_t, std::size_t>>>;
+
+} //namespace detail
+
+//Vector with a fixed compile-time capacity stored inside the object. Never allocates.
+//Growing past N throws std::length_error from push_back/emplace_back/insert/resize; the try_*
+//variants instead return nullptr, which costs a single comparison.
+template <class T, std::size_t N>
+class static_vector {
+public:
+    // types:
+    using value_type             = T;
+    using reference              = value_type&;
+    using const_reference        = const value_type&;
+    using size_type              = detail::smallest_size_t<N>;
+    using difference_type        = std::ptrdiff_t;
+
+    using pointer                = T*;
+    using const_pointer          = const T*;
+    using iterator               = T*;
+    using const_iterator         = const T*;
+    using reverse_iterator       = std::reverse_iterator<iterator>;
+    using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+    // construct/copy/destroy:
+    static_vector() noexcept;
+    explicit static_vector(std::size_t size);
+    static_vector(std::size_t size, const T& value);
+
+    template <class InputIterator, class = typename std::iterator_traits<InputIterator>::iterator_category>
+    static_vector(InputIterator first, InputIterator last);
+
+    static_vector(const static_vector& other);
+    static_vector(static_vector&& other) noexcept(std::is_nothrow_move_constructible<T>::value);
+    static_vector(std::initializer_list<T>);
+
+    ~static_vector();
+
+    static_vector& operator=(const static_vector& rhs);
+    static_vector& operator=(static_vector&& rhs) noexcept(std::is_nothrow_move_assignable<T>::value &&
+                                                           std::is_nothrow_move_constructible<T>::value);
+    static_vector& operator=(std::initializer_list<T>);
+
+    template <class InputIterator, class = typename std::iterator_traits<InputIterator>::iterator_category>
+    void assign(InputIterator first, InputIterator last);
+    void assign(std::size_t n, const T& elem);
+    void assign(std::initializer_list<T>);
+
+    // iterators:
+    iterator                begin() noexcept        { return data(); }
+    const_iterator          begin() const noexcept  { return data(); }
+    iterator                end() noexcept          { return data() + size_; }
+    const_iterator          end() const noexcept    { return data() + size_; }
+
+    reverse_iterator        rbegin() noexcept       { return reverse_iterator(end()); }
+    const_reverse_iterator  rbegin() const noexcept { return const_reverse_iterator(end()); }
+    reverse_iterator        rend() noexcept         { return reverse_iterator(begin()); }
+    const_reverse_iterator  rend() const noexcept   { return const_reverse_iterator(begin()); }
+
+    const_iterator          cbegin() const noexcept  { return begin(); }
+    const_iterator          cend() const noexcept    { return end(); }
+    const_reverse_iterator  crbegin() const noexcept { return rbegin(); }
+    const_reverse_iterator  crend() const noexcept   { return rend(); }
+
+    // capacity:
+    size_type size() const noexcept { return size_; }
+    static constexpr size_type max_size() noexcept { return N; }
+    static constexpr size_type capacity() noexcept { return N; }
+    bool      empty() const noexcept { return size_ == 0; }
+    bool      full() const noexcept { return size_ == N; }
+    void      resize(std::size_t new_size);
+    void      resize(std::size_t new_size, const T& elem);
+    void      reserve(std::size_t capacity);
+    void      shrink_to_fit() noexcept {}
+
+    // element access:
+    reference       operator[](std::size_t n)       { return data()[n]; }
+    const_reference operator[](std::size_t n) const { return data()[n]; }
+    reference       at(std::size_t pos);
+    const_reference at(std::size_t pos) const;
+    reference       front()       { return data()[0]; }
+    const_reference front() const { return data()[0]; }
+    reference       back()        { return data()[size_ - 1]; }
+    const_reference back() const  { return data()[size_ - 1]; }
+
+    //data access
+    pointer       data() noexcept       { return reinterpret_cast<T*>(storage_); }
+    const_pointer data() const noexcept { return reinterpret_cast<const T*>(storage_); }
+
+    // modifiers:
+    template <class... Args> reference emplace_back(Args&& ...args);
+    void push_back(const T& elem);
+    void push_back(T&& elem);
+    //return the new element, or nullptr if the vector is full
+    template <class... Args> pointer try_emplace_back(Args&& ...args);
+    pointer try_push_back(const T& elem);
+    pointer try_push_back(T&& elem);
+    void pop_back();
+
+    template <class... Args> iterator emplace(const_iterator position, Args&&... args);
+    iterator insert(const_iterator position, const T& elem);
+    iterator insert(const_iterator position, T&& elem);
+    iterator insert(const_iterator position, std::size_t n, const T& elem);
+    template <class InputIterator, class = typename std::iterator_traits<InputIterator>::iterator_category>
+    iterator insert(const_iterator position, InputIterator first, InputIterator last);
+    iterator insert(const_iterator position, std::initializer_list<T>);
+
+    iterator erase(const_iterator position);
+    iterator erase(const_iterator first, const_iterator last);
+    void     swap(static_vector&) noexcept(std::is_nothrow_move_constructible<T>::value &&
+                                           std::is_nothrow_swappable<T>::value);
+    void     clear() noexcept;
+
+private:
+    alignas(T) unsigned char storage_[N * sizeof(T) > 0 ? N * sizeof(T) : 1];
+    size_type size_;
+
+    void check_room(std::size_t n) const;
+    void destruct_data(std::size_t from = 0) noexcept;
+    iterator open_gap(const_iterator position, std::size_t n);
+};
+
+template<class T, std::size_t N>
+static_vector<T, N>::static_vector() noexcept
+        : size_(0) {}
+
+template<class T, std::size_t N>
+static_vector<T, N>::static_vector(std::size_t size)
+        : size_(0)
+{
+    resize(size);
+}
+
+template<class T, std::size_t N>
+static_vector<T, N>::static_vector(std::size_t size, const T& value)
+        : size_(0)
+{
+    resize(size, value);
+}
+
+template<class T, std::size_t N>
+template<class InputIterator, class>
+static_vector<T, N>::static_vector(InputIterator first, InputIterator last)
+        : size_(0)
+{
+    assign(first, last);
+}
+
+template<class T, std::size_t N>
+static_vector<T, N>::static_vector(const static_vector& other)
+        : size_(0)
+{
+    std::uninitialized_copy(other.begin(), other.end(), data());
+    size_ = other.size_;
+}
+
+template<class T, std::size_t N>
+static_vector<T, N>::static_vector(static_vector&& other) noexcept(std::is_nothrow_move_constructible<T>::value)
+        : size_(0)
+{
+    std::uninitialized_move(other.begin(), other.end(), data());
+    size_ = other.size_;
+}
+
+template<class T, std::size_t N>
+static_vector<T, N>::static_vector(std::initializer_list<T> ilist)
+        : size_(0)
+{
+    assign(ilist.begin(), ilist.end());
+}
+
+template<class T, std::size_t N>
+static_vector<T, N>::~static_vector()
+{
+    destruct_data();
+}
+
+template<class T, std::size_t N>
+static_vector<T, N>& static_vector<T, N>::operator=(const static_vector& rhs)
+{
+    if (this != &rhs) {
+        assign(rhs.begin(), rhs.end());
+    }
+    return *this;
+}
+
+template<class T, std::size_t N>
+static_vector<T, N>& static_vector<T, N>::operator=(static_vector&& rhs)
+        noexcept(std::is_nothrow_move_assignable<T>::value && std::is_nothrow_move_constructible<T>::value)
+{
+    if (this != &rhs) {
+        assign(std::make_move_iterator(rhs.begin()), std::make_move_iterator(rhs.end()));
+    }
+    return *this;
+}
+
+template<class T, std::size_t N>
+static_vector<T, N>& static_vector<T, N>::operator=(std::initializer_list<T> ilist)
+{
+    assign(ilist.begin(), ilist.end());
+    return *this;
+}
+
+template<class T, std::size_t N>
+template<class InputIterator, class>
+void static_vector<T, N>::assign(InputIterator first, InputIterator last)
+{
+    auto size = static_cast<std::size_t>(std::distance(first, last));
+    check_room(size);
+
+    //assign over live elements, construct or destroy only the difference
+    size_type i = 0;
+    for (; first != last && i < size_; ++first, ++i) {
+        data()[i] = *first;
+    }
+
+    if (first != last) {
+        std::uninitialized_copy(first, last, data() + size_);
+    } else {
+        destruct_data(i);
+    }
+    size_ = static_cast<size_type>(size);
+}
+
+template<class T, std::size_t N>
+void static_vector<T, N>::assign(std::size_t n, const T& elem)
+{
+    check_room(n);
+    std::fill_n(data(), std::min<std::size_t>(n, size_), elem);
+
+    if (n > size_) {
+        std::uninitialized_fill_n(data() + size_, n - size_, elem);
+    } else {
+        destruct_data(n);
+    }
+    size_ = static_cast<size_type>(n);
+}
+
+template<class T, std::size_t N>
+void static_vector<T, N>::assign(std::initializer_list<T> ilist)
+{
+    assign(ilist.begin(), ilist.end());
+}
+
+template<class T, std::size_t N>
+void static_vector<T, N>::resize(std::size_t new_size)
+{
+    check_room(new_size);
+
+    if (new_size < size_) {
+        destruct_data(new_size);
+    } else {
+        std::uninitialized_value_construct_n(data() + size_, new_size - size_);
+    }
+    size_ = static_cast<size_type>(new_size);
+}
+
+template<class T, std::size_t N>
+void static_vector<T, N>::resize(std::size_t new_size, const T& elem)
+{
+    check_room(new_size);
+
+    if (new_size < size_) {
+        destruct_data(new_size);
+    } else {
+        std::uninitialized_fill_n(data() + size_, new_size - size_, elem);
+    }
+    size_ = static_cast<size_type>(new_size);
+}
+
+template<class T, std::size_t N>
+void static_vector<T, N>::reserve(std::size_t capacity)
+{
+    check_room(capacity);
+}
+
+template<class T, std::size_t N>
+typename static_vector<T, N>::reference static_vector<T, N>::at(std::size_t pos)
+{
+    if (size() <= pos) {
+        throw std::out_of_range("Index out of range");
+    }
+    return data()[pos];
+}
+
+template<class T, std::size_t N>
+typename static_vector<T, N>::const_reference static_vector<T, N>::at(std::size_t pos) const
+{
+    if (size() <= pos) {
+        throw std::out_of_range("Index out of range");
+    }
+    return data()[pos];
+}
+
+template<class T, std::size_t N>
+template<class... Args>
+typename static_vector<T, N>::reference static_vector<T, N>::emplace_back(Args&& ...args)
+{
+    check_room(size_ + std::size_t(1));
+    return *try_emplace_back(std::forward<Args>(args)...);
+}
+
+template<class T, std::size_t N>
+void static_vector<T, N>::push_back(const T& elem)
+{
+    emplace_back(elem);
+}
+
+template<class T, std::size_t N>
+void static_vector<T, N>::push_back(T&& elem)
+{
+    emplace_back(std::move(elem));
+}
+
+template<class T, std::size_t N>
+template<class... Args>
+typename static_vector<T, N>::pointer static_vector<T, N>::try_emplace_back(Args&& ...args)
+{
+    if (size_ == N) {
+        return nullptr;
+    }
+
+    auto p = ::new (static_cast<void*>(data() + size_)) T(std::forward<Args>(args)...);
+    size_++;
+    return p;
+}
+
+template<class T, std::size_t N>
+typename static_vector<T, N>::pointer static_vector<T, N>::try_push_back(const T& elem)
+{
+    return try_emplace_back(elem);
+}
+
+template<class T, std::size_t N>
+typename static_vector<T, N>::pointer static_vector<T, N>::try_push_back(T&& elem)
+{
+    return try_emplace_back(std::move(elem));
+}
+
+template<class T, std::size_t N>
+void static_vector<T, N>::pop_back()
+{
+    if (size_ > 0) {
+        --size_;
+        std::destroy_at(data() + size_);
+    }
+}
+
+template<class T, std::size_t N>
+template<class... Args>
+typename static_vector<T, N>::iterator static_vector<T, N>::emplace(const_iterator position, Args&&... args)
+{
+    //build the element first: args may alias an element that is about to move
+    T value(std::forward<Args>(args)...);
+    auto pos = open_gap(position, 1);
+    ::new (static_cast<void*>(pos)) T(std::move(value));
+    size_++;
+    return pos;
+}
+
+template<class T, std::size_t N>
+typename static_vector<T, N>::iterator static_vector<T, N>::insert(const_iterator position, const T& elem)
+{
+    return emplace(position, elem);
+}
+
+template<class T, std::size_t N>
+typename static_vector<T, N>::iterator static_vector<T, N>::insert(const_iterator position, T&& elem)
+{
+    return emplace(position, std::move(elem));
+}
+
+template<class T, std::size_t N>
+typename static_vector<T, N>::iterator static_vector<T, N>::insert(const_iterator position, std::size_t n, const T& elem)
+{
+    T value(elem);
+    auto pos = open_gap(position, n);
+    std::uninitialized_fill_n(pos, n, value);
+    size_ += n;
+    return pos;
+}
+
+template<class T, std::size_t N>
+template<class InputIterator, class>
+typename static_vector<T, N>::iterator
+static_vector<T, N>::insert(const_iterator position, InputIterator first, InputIterator last)
+{
+    auto n = static_cast<std::size_t>(std::distance(first, last));
+    check_room(size_ + std::size_t(n));
+
+    auto pos = open_gap(position, n);
+    std::uninitialized_copy(first, last, pos);
+    size_ += n;
+    return pos;
+}
+
+template<class T, std::size_t N>
+typename static_vector<T, N>::iterator static_vector<T, N>::insert(const_iterator position, std::initializer_list<T> ilist)
+{
+    return insert(position, ilist.begin(), ilist.end());
+}
+
+template<class T, std::size_t N>
+typename static_vector<T, N>::iterator static_vector<T, N>::erase(const_iterator position)
+{
+    return erase(position, position + 1);
+}
+
+template<class T, std::size_t N>
+typename static_vector<T, N>::iterator static_vector<T, N>::erase(const_iterator first, const_iterator last)
+{
+    auto pos = begin() + (first - cbegin());
+    auto count = static_cast<std::size_t>(last - first);
+
+    if (count != 0) {
+        std::move(pos + count, end(), pos);
+        destruct_data(size_ - count);
+        size_ -= count;
+    }
+    return pos;
+}
+
+template<class T, std::size_t N>
+void static_vector<T, N>::swap(static_vector& other)
+        noexcept(std::is_nothrow_move_constructible<T>::value && std::is_nothrow_swappable<T>::value)
+{
+    auto& longer  = size_ >= other.size_ ? *this : other;
+    auto& shorter = size_ >= other.size_ ? other : *this;
+
+    std::swap_ranges(shorter.begin(), shorter.end(), longer.begin());
+    std::uninitialized_move(longer.begin() + shorter.size_, longer.end(), shorter.end());
+    longer.destruct_data(shorter.size_);
+    std::swap(size_, other.size_);
+}
+
+template<class T, std::size_t N>
+void static_vector<T, N>::clear() noexcept
+{
+    destruct_data();
+    size_ = 0;
+}
+
+template<class T, std::size_t N>
+void static_vector<T, N>::check_room(std::size_t n) const
+{
+    if (n > N) {
+        throw std::length_error("static_vector capacity exceeded");
+    }
+}
+
+template<class T, std::size_t N>
+void static_vector<T, N>::destruct_data(std::size_t from) noexcept
+{
+    std::destroy(data() + from, data() + size_);
+}
+
+//Shifts [position, end) right by n slots; the n slots at the returned position are left
+//uninitialized (moved-from elements inside the live range are destroyed).
+template<class T, std::size_t N>
+typename static_vector<T, N>::iterator static_vector<T, N>::open_gap(const_iterator position, std::size_t n)
+{
+    check_room(size_ + std::size_t(n));
+
+    auto pos = begin() + (position - cbegin());
+    auto tail = static_cast<std::size_t>(end() - pos);
+
+    if (n == 0) {
+        return pos;
+    }
+
+    if (tail > n) {
+        std::uninitialized_move(end() - n, end(), end());
+        std::move_backward(pos, end() - n, end());
+        std::destroy(pos, pos + n);
+    } else {
+        std::uninitialized_move(pos, end(), pos + n);
+        std::destroy(pos, end());
+    }
+    return pos;
+}
+
+template <class T, std::size_t N>
+bool operator==(const static_vector<T, N>& lhs, const static_vector<T, N>& rhs)
+{
+    return lhs.size() == rhs.size() && std::equal(lhs.begin(), lhs.end(), rhs.begin());
+}
+
+template <class T, std::size_t N>
+bool operator!=(const static_vector<T, N>& lhs, const static_vector<T, N>& rhs)
+{
+    return !(lhs == rhs);
+}
+
+template <class T, std::size_t N>
+bool operator<(const static_vector<T, N>& lhs, const static_vector<T, N>& rhs)
+{
+    return std::lexicographical_compare(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
+}
+
+template <class T, std::size_t N>
+bool operator>(const static_vector<T, N>& lhs, const static_vector<T, N>& rhs)
+{
+    return rhs < lhs;
+}
+
+template <class T, std::size_t N>
+bool operator<=(const static_vector<T, N>& lhs, const static_vector<T, N>& rhs)
+{
+    return !(rhs < lhs);
+}
+
+template <class T, std::size_t N>
+bool operator>=(const static_vector<T, N>& lhs, const static_vector<T, N>& rhs)
+{
+    return !(lhs < rhs);
+}
+
+template <class T, std::size_t N>
+void swap(static_vector<T, N>& lhs, static_vector<T, N>& rhs) noexcept(noexcept(lhs.swap(rhs)))
+{
+    lhs.swap(rhs);
+}
+
+} //namespace atl
@@ -0,0 +1,315 @@
+#pragma once
+
+#include <mutex>
+#include <atomic>
+#include <deque>
+#include <memory>
+#include <thread>
+#include <cstddef>
+#include <utility>
+#include <algorithm>
+#include <exception>
+#include <type_traits>
+#include <condition_variable>
+#include "vector.h"
+#include "cache_line.h"
+
+namespace atl {
+namespace parallel {
+
+//Fork-join pool with work stealing. Every worker owns a deque: it splits ranges in half,
+//pushes the upper half onto the back of its own deque and keeps working on the lower half,
+//and when idle steals the oldest (largest) range from the front of another deque. The thread
+//that calls for_range takes part too, through one extra queue shared by outside callers, so a
+//pool of concurrency() == n has n - 1 worker threads. Nested for_range calls from inside a
+//body run on the calling worker's own deque.
+//
+//Threads with nothing to do block on a condition variable instead of polling. A sleeper bumps
+//sleeping_ and then looks for work; a producer publishes work and then reads sleeping_. A
+//seq_cst fence on both sides of that exchange guarantees one of them sees the other, and
+//the notify is sent under the mutex the sleeper holds until it is actually waiting, so no
+//wakeup is lost.
+class thread_pool {
+public:
+    explicit thread_pool(std::size_t concurrency = std::thread::hardware_concurrency());
+    thread_pool(const thread_pool&) = delete;
+    thread_pool& operator=(const thread_pool&) = delete;
+    ~thread_pool();
+
+    //number of threads that run work, the caller included
+    std::size_t concurrency() const noexcept { return queue_count_; }
+
+    //Calls body(begin, end) on disjoint ranges no longer than grain that together cover [0, n),
+    //and returns once all calls have finished. If a call throws, the ranges not yet started are
+    //skipped and the first exception is rethrown here.
+    template <class F>
+    void for_range(std::size_t n, std::size_t grain, F&& body);
+
+    //shared pool with one thread per hardware thread
+    static thread_pool& default_pool();
+
+private:
+    struct job
+    {
+        void (*run)(void* body, std::size_t begin, std::size_t end);
+        void* body;
+        std::size_t grain;
+        std::atomic<std::size_t> pending;
+        std::atomic<bool> failed;
+        std::exception_ptr error;
+    };
+
+    struct task
+    {
+        job* owner;
+        std::size_t begin;
+        std::size_t end;
+    };
+
+    struct alignas(cache_line_size) queue
+    {
+        std::mutex mutex;
+        std::deque<task> tasks;
+    };
+
+    struct worker_identity
+    {
+        const thread_pool* pool = nullptr;
+        std::size_t queue = 0;
+    };
+
+    //queue 0 is shared by outside callers, queue i + 1 belongs to worker i
+    std::size_t queue_count_;
+    std::unique_ptr<queue[]> queues_;
+    atl::vector<std::thread> workers_;
+
+    std::atomic<bool> stop_;
+    std::atomic<std::size_t> sleeping_;
+    std::mutex sleep_mutex_;
+    std::condition_variable wake_;
+
+    static worker_identity& this_worker();
+    std::size_t queue_of_this_thread() const;
+
+    void stop_workers() noexcept;
+    void worker_loop(std::size_t index);
+    void execute(task t, std::size_t index);
+    void help_until_done(job& j, std::size_t index);
+    void sleep_unless(const std::atomic<std::size_t>* pending);
+    void wake_sleepers(bool all);
+    void push(std::size_t index, task t);
+    bool try_pop(std::size_t index, task& out);
+    bool try_steal(std::size_t index, task& out);
+    bool has_work();
+};
+
+inline thread_pool::thread_pool(std::size_t concurrency)
+        : queue_count_(std::max<std::size_t>(concurrency, 1)),
+          queues_(new queue[queue_count_]),
+          stop_(false),
+          sleeping_(0)
+{
+    try {
+        workers_.reserve(queue_count_ - 1);
+        for (std::size_t i = 0; i + 1 < queue_count_; i++) {
+            workers_.emplace_back([this, i] { worker_loop(i + 1); });
+        }
+    } catch (...) {
+        //joinable threads would make ~vector<std::thread> call std::terminate
+        stop_workers();
+        throw;
+    }
+}
+
+inline thread_pool::~thread_pool()
+{
+    stop_workers();
+}
+
+inline void thread_pool::stop_workers() noexcept
+{
+    {
+        std::lock_guard<std::mutex> lock(sleep_mutex_);
+        stop_.store(true);
+    }
+    wake_.notify_all();
+    for (auto& worker : workers_) {
+        worker.join();
+    }
+}
+
+inline thread_pool& thread_pool::default_pool()
+{
+    static thread_pool pool;
+    return pool;
+}
+
+template <class F>
+void thread_pool::for_range(std::size_t n, std::size_t grain, F&& body)
+{
+    if (n == 0) {
+        return;
+    }
+
+    grain = std::max<std::size_t>(grain, 1);
+    if (queue_count_ == 1 || n <= grain) {
+        body(std::size_t(0), n);
+        return;
+    }
+
+    using body_type = typename std::remove_reference<F>::type;
+    job j;
+    j.run = [](void* b, std::size_t begin, std::size_t end) { (*static_cast<body_type*>(b))(begin, end); };
+    j.body = const_cast<void*>(static_cast<const void*>(std::addressof(body)));
+    j.grain = grain;
+    j.pending.store(1, std::memory_order_relaxed);
+    j.failed.store(false, std::memory_order_relaxed);
+
+    auto index = queue_of_this_thread();
+    execute(task{&j, 0, n}, index);
+    help_until_done(j, index);
+
+    if (j.error) {
+        std::rethrow_exception(j.error);
+    }
+}
+
+inline thread_pool::worker_identity& thread_pool::this_worker()
+{
+    thread_local worker_identity identity;
+    return identity;
+}
+
+inline std::size_t thread_pool::queue_of_this_thread() const
+{
+    auto& identity = this_worker();
+    return identity.pool == this ? identity.queue : 0;
+}
+
+inline void thread_pool::worker_loop(std::size_t index)
+{
+    this_worker() = worker_identity{this, index};
+
+    while (!stop_.load(std::memory_order_relaxed)) {
+        task t;
+        if (try_pop(index, t) || try_steal(index, t)) {
+            execute(t, index);
+            continue;
+        }
+
+        sleep_unless(nullptr);
+    }
+}
+
+//Blocks until work is pushed, the pool stops or *pending (if given) drops to zero.
+inline void thread_pool::sleep_unless(const std::atomic<std::size_t>* pending)
+{
+    std::unique_lock<std::mutex> lock(sleep_mutex_);
+    sleeping_.fetch_add(1);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (!stop_.load() && !has_work() && (pending == nullptr || pending->load() != 0)) {
+        wake_.wait(lock);
+    }
+    sleeping_.fetch_sub(1);
+}
+
+inline void thread_pool::wake_sleepers(bool all)
+{
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (sleeping_.load() != 0) {
+        std::lock_guard<std::mutex> lock(sleep_mutex_);
+        if (all) {
+            wake_.notify_all();
+        } else {
+            wake_.notify_one();
+        }
+    }
+}
+
+//Splits t down to the grain, leaving the upper halves for thieves, then runs what is left.
+inline void thread_pool::execute(task t, std::size_t index)
+{
+    auto& owner = *t.owner;
+    while (t.end - t.begin > owner.grain) {
+        auto middle = t.begin + (t.end - t.begin) / 2;
+        owner.pending.fetch_add(1, std::memory_order_relaxed);
+        push(index, task{&owner, middle, t.end});
+        t.end = middle;
+    }
+
+    if (!owner.failed.load(std::memory_order_relaxed)) {
+        try {
+            owner.run(owner.body, t.begin, t.end);
+        } catch (...) {
+            if (!owner.failed.exchange(true)) {
+                owner.error = std::current_exception();
+            }
+        }
+    }
+
+    //the job may be gone as soon as pending reaches zero; its caller may be asleep in
+    //help_until_done, and notify_one could pick an idle worker instead
+    if (owner.pending.fetch_sub(1) == 1) {
+        wake_sleepers(true);
+    }
+}
+
+inline void thread_pool::help_until_done(job& j, std::size_t index)
+{
+    while (j.pending.load(std::memory_order_acquire) != 0) {
+        task t;
+        if (try_pop(index, t) || try_steal(index, t)) {
+            execute(t, index);
+        } else {
+            sleep_unless(&j.pending);
+        }
+    }
+}
+
+inline void thread_pool::push(std::size_t index, task t)
+{
+    {
+        std::lock_guard<std::mutex> lock(queues_[index].mutex);
+        queues_[index].tasks.push_back(t);
+    }
+    wake_sleepers(false);
+}
+
+inline bool thread_pool::try_pop(std::size_t index, task& out)
+{
+    std::lock_guard<std::mutex> lock(queues_[index].mutex);
+    if (queues_[index].tasks.empty()) {
+        return false;
+    }
+    out = queues_[index].tasks.back();
+    queues_[index].tasks.pop_back();
+    return true;
+}
+
+inline bool thread_pool::try_steal(std::size_t index, task& out)
+{
+    for (std::size_t i = 1; i < queue_count_; i++) {
+        auto& victim = queues_[(index + i) % queue_count_];
+        std::lock_guard<std::mutex> lock(victim.mutex);
+        if (!victim.tasks.empty()) {
+            out = victim.tasks.front();
+            victim.tasks.pop_front();
+            return true;
+        }
+    }
+    return false;
+}
+
+inline bool thread_pool::has_work()
+{
+    for (std::size_t i = 0; i < queue_count_; i++) {
+        std::lock_guard<std::mutex> lock(queues_[i].mutex);
+        if (!queues_[i].tasks.empty()) {
+            return true;
+        }
+    }
+    return false;
+}
+
+} //namespace parallel
+} //namespace atl
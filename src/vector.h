@@ -1,17 +1,23 @@
 #pragma once
 
 #include <memory>
-#include <cmath>
 #include <utility>
 #include <iterator>
 #include <algorithm>
+#include <cstring>
+#include <stdexcept>
 #include <initializer_list>
+#include <memory_resource>
 #include "vector_iterator.h"
+#include "relocate.h"
+#include "allocator_support.h"
+#include "growth_policy.h"
+#include "compare.h"
 
 //Alexey template library
 namespace atl {
 
-template <class T, class Allocator>
+template <class T, class Allocator, class GrowthPolicy>
 class vector {
 public:
     // types:
@@ -22,6 +28,7 @@ public:
     using difference_type        = std::ptrdiff_t ;
 
     using allocator_type         = Allocator;
+    using growth_policy          = GrowthPolicy;
     using pointer                = typename std::allocator_traits<Allocator>::pointer;
     using const_pointer          = typename std::allocator_traits<Allocator>::const_pointer;
     using iterator               = VectorIterator<T, false>;
@@ -31,14 +38,17 @@ public:
 
     // construct/copy/destroy:
     explicit vector(const Allocator& alloc = Allocator());
-    explicit vector(size_type size);
+    explicit vector(size_type size, const Allocator& = Allocator());
     vector(size_type size, const T& value, const Allocator& = Allocator());
 
     template <class InputIterator, class = typename std::iterator_traits<InputIterator>::iterator_category>
     vector(InputIterator first, InputIterator last,const Allocator& = Allocator());
     //copy constructors
-    vector(const vector<T,Allocator>& other);
+    vector(const vector<T, Allocator, GrowthPolicy>& other);
     vector(const vector&, const Allocator&);
+    //copies a vector with another allocator or growth policy, e.g. a std::allocator vector onto a pmr arena
+    template <class OtherAllocator, class OtherGrowthPolicy>
+    explicit vector(const vector<T, OtherAllocator, OtherGrowthPolicy>& other, const Allocator& = Allocator());
     //move constructors
     vector(vector&&) noexcept ;
     vector(vector&&, const Allocator&);
@@ -48,9 +58,11 @@ public:
     ~vector();
 
     //operators
-    vector<T,Allocator>& operator=(const vector<T,Allocator>& rhs);
+    vector<T, Allocator, GrowthPolicy>& operator=(const vector<T, Allocator, GrowthPolicy>& rhs);
     //ASK: why move operators should be noexcept?
-    vector<T,Allocator>& operator=(vector<T,Allocator>&& rhs) noexcept;
+    vector<T, Allocator, GrowthPolicy>& operator=(vector<T, Allocator, GrowthPolicy>&& rhs)
+        noexcept(std::allocator_traits<Allocator>::propagate_on_container_move_assignment::value ||
+                 std::allocator_traits<Allocator>::is_always_equal::value);
     vector& operator=(std::initializer_list<T>);
 
     template <class InputIterator, class = typename std::iterator_traits<InputIterator>::iterator_category>
@@ -116,33 +128,52 @@ public:
 
     iterator erase(const_iterator position);
     iterator erase(const_iterator first, const_iterator last);
-    void     swap(vector<T,Allocator>&);
+
+    //O(1) erasure for when element order does not matter: the last element is moved into the hole
+    iterator unordered_erase(const_iterator position);
+    template <class Predicate>
+    size_type unordered_erase_if(Predicate pred);
+    //indices must be sorted ascending and unique
+    template <class BidirectionalIterator>
+    size_type unordered_erase_indices(BidirectionalIterator first, BidirectionalIterator last);
+    size_type unordered_erase_indices(std::initializer_list<size_type> indices);
+
+    //Batched edits moving every element at most once. Positions and indices refer to the vector
+    //before the call and must be sorted ascending (unique for erase_indices). values must not
+    //refer to elements of this vector. T must be nothrow move constructible or trivially
+    //relocatable. If constructing a value throws, insert_many leaves the vector unchanged when
+    //it had to grow, and otherwise keeps every old element but only some of the new values.
+    template <class PositionIterator, class InputIterator>
+    void      insert_many(PositionIterator positions_first, PositionIterator positions_last, InputIterator values_first);
+    void      insert_many(std::initializer_list<size_type> positions, std::initializer_list<T> values);
+    template <class IndexIterator>
+    size_type erase_indices(IndexIterator first, IndexIterator last);
+    size_type erase_indices(std::initializer_list<size_type> indices);
+
+    void     swap(vector<T, Allocator, GrowthPolicy>&) noexcept;
     void     clear() noexcept;
 
     //Operators
-    template <class U, class UAllocator>
-    friend bool operator==(const vector<U, UAllocator>& lhs, const vector<U, UAllocator>& rhs);
-
-    template <class U, class UAllocator>
-    friend bool operator<(const vector<U, UAllocator>& lhs, const vector<U, UAllocator>& rhs);
-
-    template <class U, class UAllocator>
-    friend bool operator!=(const vector<U, UAllocator>& lhs, const vector<U,UAllocator>& rhs);
+    template <class U, class UAllocator, class UGrowthPolicy>
+    friend bool operator==(const vector<U, UAllocator, UGrowthPolicy>& lhs, const vector<U, UAllocator, UGrowthPolicy>& rhs);
 
-    template <class U, class UAllocator>
-    friend bool operator> (const vector<U, UAllocator>& lhs, const vector<U, UAllocator>& rhs);
+    template <class U, class UAllocator, class UGrowthPolicy>
+    friend bool operator<(const vector<U, UAllocator, UGrowthPolicy>& lhs, const vector<U, UAllocator, UGrowthPolicy>& rhs);
 
-    template <class U, class UAllocator>
-    friend bool operator>=(const vector<U, UAllocator>& lhs, const vector<U, UAllocator>& rhs);
+    template <class U, class UAllocator, class UGrowthPolicy>
+    friend bool operator!=(const vector<U, UAllocator, UGrowthPolicy>& lhs, const vector<U, UAllocator, UGrowthPolicy>& rhs);
 
-    template <class U, class UAllocator>
-    friend bool operator<=(const vector<U, UAllocator>& lhs, const vector<U, UAllocator>& rhs);
+    template <class U, class UAllocator, class UGrowthPolicy>
+    friend bool operator> (const vector<U, UAllocator, UGrowthPolicy>& lhs, const vector<U, UAllocator, UGrowthPolicy>& rhs);
 
-private:
-    static constexpr double     INCREASE_CAPACITY_FACTOR = 1.5;
+    template <class U, class UAllocator, class UGrowthPolicy>
+    friend bool operator>=(const vector<U, UAllocator, UGrowthPolicy>& lhs, const vector<U, UAllocator, UGrowthPolicy>& rhs);
 
-    static constexpr size_type MIN_CAPACITY             = 10;
+    template <class U, class UAllocator, class UGrowthPolicy>
+    friend bool operator<=(const vector<U, UAllocator, UGrowthPolicy>& lhs, const vector<U, UAllocator, UGrowthPolicy>& rhs);
 
+protected:
+    //storage is shared with containers built on top of vector (see small_vector.h)
     Allocator allocator_;
     pointer data_;
     size_type size_;
@@ -150,29 +181,40 @@ private:
 
     void initialize_default(size_type from = 0);
     void reserve_for_push(difference_type size = 1);
+    void reallocate(size_type capacity);
     void move_to_another_ptr(pointer);
 
-    void copy_from_another_vector(const vector<T>& other);
+    template <class OtherAllocator, class OtherGrowthPolicy>
+    void copy_from_another_vector(const vector<T, OtherAllocator, OtherGrowthPolicy>& other);
+    void swap_storage(vector& other) noexcept;
 
     template<class It, class = typename std::iterator_traits<It>::iterator_category>
     void fill_from_iterator(It first, It last);
     void deallocate_data();
     void destruct_data(size_type from = 0);
+    void clear_for_capacity(size_type capacity);
     void shift_right(const_iterator pos, difference_type distance = 1);
     void shift_left(const_iterator pos, difference_type distance = 1);
 };
 
 
-template<class T, class Allocator>
-vector<T, Allocator>::vector(const Allocator& alloc)
+template<class T, class Allocator, class GrowthPolicy>
+vector<T, Allocator, GrowthPolicy>::vector(const Allocator& alloc)
          : allocator_(alloc),
-           data_ (std::allocator_traits<Allocator>::allocate(allocator_, MIN_CAPACITY)),
+           data_(nullptr),
            size_(0),
-           capacity_(MIN_CAPACITY) {}
+           capacity_(0)
+{
+    if (GrowthPolicy::allocate_empty && GrowthPolicy::min_capacity > 0) {
+        auto allocation = atl::allocate_at_least(allocator_, GrowthPolicy::min_capacity);
+        data_ = allocation.ptr;
+        capacity_ = allocation.count;
+    }
+}
 
-template<class T, class Allocator>
-vector<T, Allocator>::vector(vector::size_type size)
-         : allocator_(Allocator()),
+template<class T, class Allocator, class GrowthPolicy>
+vector<T, Allocator, GrowthPolicy>::vector(vector::size_type size, const Allocator& alloc)
+         : allocator_(alloc),
            data_(std::allocator_traits<Allocator>::allocate(allocator_, size)),
            size_(size),
            capacity_(size)
@@ -180,8 +222,8 @@ vector<T, Allocator>::vector(vector::size_type size)
     initialize_default();
 }
 
-template<class T, class Allocator>
-vector<T, Allocator>::vector(vector::size_type size, const T& value, const Allocator& allocator)
+template<class T, class Allocator, class GrowthPolicy>
+vector<T, Allocator, GrowthPolicy>::vector(vector::size_type size, const T& value, const Allocator& allocator)
          :  allocator_(allocator),
             data_(std::allocator_traits<Allocator>::allocate(allocator_, size)),
             size_(size),
@@ -192,9 +234,9 @@ vector<T, Allocator>::vector(vector::size_type size, const T& value, const Alloc
     }
 }
 
-template<class T, class Allocator>
+template<class T, class Allocator, class GrowthPolicy>
 template<class InputIterator, class>
-vector<T, Allocator>::vector(InputIterator first, InputIterator last, const Allocator& alloc)
+vector<T, Allocator, GrowthPolicy>::vector(InputIterator first, InputIterator last, const Allocator& alloc)
          : allocator_(alloc),
            data_(std::allocator_traits<Allocator>::allocate(allocator_, std::distance(first, last))),
            size_(static_cast<size_type >(std::distance(first, last))),
@@ -206,8 +248,8 @@ vector<T, Allocator>::vector(InputIterator first, InputIterator last, const Allo
     }
 }
 
-template<class T, class Allocator>
-vector<T, Allocator>::vector(const vector<T, Allocator>& other)
+template<class T, class Allocator, class GrowthPolicy>
+vector<T, Allocator, GrowthPolicy>::vector(const vector<T, Allocator, GrowthPolicy>& other)
      : allocator_(std::allocator_traits<Allocator>::select_on_container_copy_construction(other.get_allocator())),
        data_(std::allocator_traits<Allocator>::allocate(allocator_, other.capacity_)),
        size_(other.size_),
@@ -216,8 +258,8 @@ vector<T, Allocator>::vector(const vector<T, Allocator>& other)
     copy_from_another_vector(other);
 }
 
-template<class T, class Allocator>
-vector<T, Allocator>::vector(const vector& other, const Allocator& alloc)
+template<class T, class Allocator, class GrowthPolicy>
+vector<T, Allocator, GrowthPolicy>::vector(const vector& other, const Allocator& alloc)
     : allocator_(alloc),
       data_(std::allocator_traits<Allocator>::allocate(allocator_, other.capacity_)),
       size_(other.size_),
@@ -227,28 +269,55 @@ vector<T, Allocator>::vector(const vector& other, const Allocator& alloc)
     copy_from_another_vector(other);
 }
 
-template<class T, class Allocator>
-vector<T, Allocator>::vector(vector&& other) noexcept
-        :  allocator_(Allocator()),
-           data_(std::allocator_traits<Allocator>::allocate(allocator_, other.capacity_)),
+template<class T, class Allocator, class GrowthPolicy>
+template<class OtherAllocator, class OtherGrowthPolicy>
+vector<T, Allocator, GrowthPolicy>::vector(const vector<T, OtherAllocator, OtherGrowthPolicy>& other, const Allocator& alloc)
+    : allocator_(alloc),
+      data_(std::allocator_traits<Allocator>::allocate(allocator_, other.size())),
+      size_(other.size()),
+      capacity_(other.size())
+{
+    copy_from_another_vector(other);
+}
+
+template<class T, class Allocator, class GrowthPolicy>
+vector<T, Allocator, GrowthPolicy>::vector(vector&& other) noexcept
+        :  allocator_(std::move(other.allocator_)),
+           data_(other.data_),
            size_(other.size_),
            capacity_(other.capacity_)
 {
-    other.data_ = nullptr;
+    other.data_     = nullptr;
+    other.size_     = 0;
+    other.capacity_ = 0;
 }
 
-template<class T, class Allocator>
-vector<T, Allocator>::vector(vector&& other, const Allocator& alloc)
+template<class T, class Allocator, class GrowthPolicy>
+vector<T, Allocator, GrowthPolicy>::vector(vector&& other, const Allocator& alloc)
      :  allocator_(alloc),
-        data_(std::allocator_traits<Allocator>::allocate(allocator_, other.capacity_)),
-        size_(other.size_),
-        capacity_(other.capacity_)
+        data_(nullptr),
+        size_(0),
+        capacity_(0)
 {
-    other.data_ = nullptr;
+    if (allocator_ == other.allocator_) {
+        swap_storage(other);
+        return;
+    }
+
+    //other's buffer belongs to a different allocator: move the elements over
+    if (other.size_ != 0) {
+        auto allocation = atl::allocate_at_least(allocator_, other.size_);
+        data_     = allocation.ptr;
+        capacity_ = allocation.count;
+
+        for (; size_ < other.size_; size_++) {
+            std::allocator_traits<Allocator>::construct(allocator_, data_ + size_, std::move(other.data_[size_]));
+        }
+    }
 }
 
-template<class T, class Allocator>
-vector<T, Allocator>::vector(std::initializer_list<T> ilist, const Allocator& alloc)
+template<class T, class Allocator, class GrowthPolicy>
+vector<T, Allocator, GrowthPolicy>::vector(std::initializer_list<T> ilist, const Allocator& alloc)
         : allocator_(alloc),
           data_(std::allocator_traits<Allocator>::allocate(allocator_, ilist.size())),
           size_(ilist.size()),
@@ -257,63 +326,63 @@ vector<T, Allocator>::vector(std::initializer_list<T> ilist, const Allocator& al
     fill_from_iterator(ilist.begin(), ilist.end());
 }
 
-template<class T, class Allocator>
-vector<T, Allocator>::~vector()
+template<class T, class Allocator, class GrowthPolicy>
+vector<T, Allocator, GrowthPolicy>::~vector()
 {
     deallocate_data();
 }
 
-template<class T, class Allocator>
-void vector<T, Allocator>::initialize_default(size_type from)
+template<class T, class Allocator, class GrowthPolicy>
+void vector<T, Allocator, GrowthPolicy>::initialize_default(size_type from)
 {
     for (size_type i = from; i < size_; i++) {
         std::allocator_traits<Allocator>::construct(allocator_, data_ + i);
     }
 }
 
-template<class T, class Allocator>
-typename vector<T, Allocator>::reference vector<T, Allocator>::operator[](vector::size_type n)
+template<class T, class Allocator, class GrowthPolicy>
+typename vector<T, Allocator, GrowthPolicy>::reference vector<T, Allocator, GrowthPolicy>::operator[](vector::size_type n)
 {
     return data_[n];
 }
 
-template<class T, class Allocator>
-typename vector<T, Allocator>::const_reference vector<T, Allocator>::operator[](vector::size_type n) const {
+template<class T, class Allocator, class GrowthPolicy>
+typename vector<T, Allocator, GrowthPolicy>::const_reference vector<T, Allocator, GrowthPolicy>::operator[](vector::size_type n) const {
     return data_[n];
 }
 
-template<class T, class Allocator>
-typename vector<T, Allocator>::size_type vector<T, Allocator>::capacity() const noexcept
+template<class T, class Allocator, class GrowthPolicy>
+typename vector<T, Allocator, GrowthPolicy>::size_type vector<T, Allocator, GrowthPolicy>::capacity() const noexcept
 {
     return capacity_;
 }
 
-template<class T, class Allocator>
-bool vector<T, Allocator>::empty() const noexcept
+template<class T, class Allocator, class GrowthPolicy>
+bool vector<T, Allocator, GrowthPolicy>::empty() const noexcept
 {
     return size_ == 0;
 }
 
-template<class T, class Allocator>
-typename vector<T, Allocator>::allocator_type vector<T, Allocator>::get_allocator() const noexcept
+template<class T, class Allocator, class GrowthPolicy>
+typename vector<T, Allocator, GrowthPolicy>::allocator_type vector<T, Allocator, GrowthPolicy>::get_allocator() const noexcept
 {
     return allocator_;
 }
 
-template<class T, class Allocator>
-typename vector<T, Allocator>::size_type vector<T, Allocator>::size() const noexcept
+template<class T, class Allocator, class GrowthPolicy>
+typename vector<T, Allocator, GrowthPolicy>::size_type vector<T, Allocator, GrowthPolicy>::size() const noexcept
 {
     return size_;
 }
 
-template<class T, class Allocator>
-typename vector<T, Allocator>::size_type vector<T, Allocator>::max_size() const noexcept
+template<class T, class Allocator, class GrowthPolicy>
+typename vector<T, Allocator, GrowthPolicy>::size_type vector<T, Allocator, GrowthPolicy>::max_size() const noexcept
 {
     return std::allocator_traits<Allocator>::max_size(allocator_);
 }
 
-template<class T, class Allocator>
-typename vector<T, Allocator>::reference vector<T, Allocator>::at(vector::size_type pos)
+template<class T, class Allocator, class GrowthPolicy>
+typename vector<T, Allocator, GrowthPolicy>::reference vector<T, Allocator, GrowthPolicy>::at(vector::size_type pos)
 {
     if (pos < 0 || size() <= pos) {
         throw std::out_of_range("Index out of range");
@@ -321,8 +390,8 @@ typename vector<T, Allocator>::reference vector<T, Allocator>::at(vector::size_t
     return data_[pos];
 }
 
-template<class T, class Allocator>
-typename vector<T, Allocator>::const_reference vector<T, Allocator>::at(vector::size_type pos) const
+template<class T, class Allocator, class GrowthPolicy>
+typename vector<T, Allocator, GrowthPolicy>::const_reference vector<T, Allocator, GrowthPolicy>::at(vector::size_type pos) const
 {
     if (pos < 0 || size() <= pos) {
         throw std::out_of_range("Index out of range");
@@ -330,62 +399,62 @@ typename vector<T, Allocator>::const_reference vector<T, Allocator>::at(vector::
     return data_[pos];
 }
 
-template<class T, class Allocator>
-typename vector<T, Allocator>::reference vector<T, Allocator>::front()
+template<class T, class Allocator, class GrowthPolicy>
+typename vector<T, Allocator, GrowthPolicy>::reference vector<T, Allocator, GrowthPolicy>::front()
 {
     return data_[0];
 }
 
-template<class T, class Allocator>
-typename vector<T, Allocator>::const_reference vector<T, Allocator>::front() const
+template<class T, class Allocator, class GrowthPolicy>
+typename vector<T, Allocator, GrowthPolicy>::const_reference vector<T, Allocator, GrowthPolicy>::front() const
 {
     return data_[0];
 }
 
-template<class T, class Allocator>
-typename vector<T, Allocator>::reference vector<T, Allocator>::back()
+template<class T, class Allocator, class GrowthPolicy>
+typename vector<T, Allocator, GrowthPolicy>::reference vector<T, Allocator, GrowthPolicy>::back()
 {
     return data_[size_ - 1];
 }
 
-template<class T, class Allocator>
-typename vector<T, Allocator>::const_reference vector<T, Allocator>::back() const
+template<class T, class Allocator, class GrowthPolicy>
+typename vector<T, Allocator, GrowthPolicy>::const_reference vector<T, Allocator, GrowthPolicy>::back() const
 {
     return data_[size_ - 1];
 }
 
-template<class T, class Allocator>
-typename vector<T, Allocator>::pointer vector<T, Allocator>::data() noexcept
+template<class T, class Allocator, class GrowthPolicy>
+typename vector<T, Allocator, GrowthPolicy>::pointer vector<T, Allocator, GrowthPolicy>::data() noexcept
 {
     return data_;
 }
 
-template<class T, class Allocator>
-typename vector<T, Allocator>::const_pointer vector<T, Allocator>::data() const noexcept
+template<class T, class Allocator, class GrowthPolicy>
+typename vector<T, Allocator, GrowthPolicy>::const_pointer vector<T, Allocator, GrowthPolicy>::data() const noexcept
 {
     return data_;
 }
 
-template<class T, class Allocator>
-void vector<T, Allocator>::push_back(const T& elem)
+template<class T, class Allocator, class GrowthPolicy>
+void vector<T, Allocator, GrowthPolicy>::push_back(const T& elem)
 {
     reserve_for_push();
     std::allocator_traits<Allocator>::construct(allocator_, data_ + size_, std::forward<const T&>(elem));
     size_++;
 }
 
-template<class T, class Allocator>
-void vector<T, Allocator>::push_back(T&& elem)
+template<class T, class Allocator, class GrowthPolicy>
+void vector<T, Allocator, GrowthPolicy>::push_back(T&& elem)
 {
     reserve_for_push();
     std::allocator_traits<Allocator>::construct(allocator_, data_ + size_, std::forward<T&&>(elem));
     size_++;
 }
 
-template<class T, class Allocator>
-void vector<T, Allocator>::resize(typename vector<T, Allocator>::size_type new_size)
+template<class T, class Allocator, class GrowthPolicy>
+void vector<T, Allocator, GrowthPolicy>::resize(typename vector<T, Allocator, GrowthPolicy>::size_type new_size)
 {
-    auto needed_capacity = std::max<size_type>(new_size, MIN_CAPACITY);
+    auto needed_capacity = std::max<size_type>(new_size, GrowthPolicy::min_capacity);
 
     if (new_size == size_) {
         return;
@@ -398,22 +467,19 @@ void vector<T, Allocator>::resize(typename vector<T, Allocator>::size_type new_s
     }
 
     if (needed_capacity > capacity_) {
-        auto new_data = std::allocator_traits<Allocator>::allocate(allocator_, needed_capacity);
-        move_to_another_ptr(new_data);
-
-        std::allocator_traits<Allocator>::deallocate(allocator_, data_, capacity_);
-        data_= new_data;
-        capacity_ = needed_capacity;
+        reallocate(needed_capacity);
     }
 
-    initialize_default(size_);
-    size_ = new_size;
+    //size_ only ever covers constructed elements, so a throwing constructor leaves a valid prefix
+    for (; size_ < new_size; size_++) {
+        std::allocator_traits<Allocator>::construct(allocator_, data_ + size_);
+    }
 }
 
-template<class T, class Allocator>
-void vector<T, Allocator>::resize(typename vector<T, Allocator>::size_type new_size, const T& elem)
+template<class T, class Allocator, class GrowthPolicy>
+void vector<T, Allocator, GrowthPolicy>::resize(typename vector<T, Allocator, GrowthPolicy>::size_type new_size, const T& elem)
 {
-    auto needed_capacity = std::max<size_type>(new_size, MIN_CAPACITY);
+    auto needed_capacity = std::max<size_type>(new_size, GrowthPolicy::min_capacity);
 
     if (new_size == size_) {
         return;
@@ -426,40 +492,26 @@ void vector<T, Allocator>::resize(typename vector<T, Allocator>::size_type new_s
     }
 
     if (needed_capacity > capacity_) {
-        auto new_data = std::allocator_traits<Allocator>::allocate(allocator_, needed_capacity);
-        move_to_another_ptr(new_data);
-
-        std::allocator_traits<Allocator>::deallocate(allocator_, data_, capacity_);
-        data_= new_data;
-        capacity_ = needed_capacity;
+        reallocate(needed_capacity);
     }
 
-
-    for (size_type i = size_; i < new_size; i++) {
-        std::allocator_traits<Allocator>::construct(allocator_, data_ + i, elem);
+    for (; size_ < new_size; size_++) {
+        std::allocator_traits<Allocator>::construct(allocator_, data_ + size_, elem);
     }
-
-    size_ = new_size;
 }
 
-template<class T, class Allocator>
-void vector<T, Allocator>::reserve(vector<T, Allocator>::size_type capacity)
+template<class T, class Allocator, class GrowthPolicy>
+void vector<T, Allocator, GrowthPolicy>::reserve(vector<T, Allocator, GrowthPolicy>::size_type capacity)
 {
     if (capacity <= capacity_) {
         return;
     }
 
-    auto new_data = std::allocator_traits<Allocator>::allocate(allocator_, capacity);
-    move_to_another_ptr(new_data);
-
-    std::allocator_traits<Allocator>::deallocate(allocator_, data_, capacity_);
-    data_= new_data;
-    capacity_ = capacity;
-    initialize_default(size_);
+    reallocate(capacity);
 }
 
-template<class T, class Allocator>
-void vector<T, Allocator>::pop_back()
+template<class T, class Allocator, class GrowthPolicy>
+void vector<T, Allocator, GrowthPolicy>::pop_back()
 {
     if (size_ > 0) {
         --size_;
@@ -467,9 +519,9 @@ void vector<T, Allocator>::pop_back()
     }
 }
 
-template<class T, class Allocator>
+template<class T, class Allocator, class GrowthPolicy>
 template<class... Args>
-typename vector<T, Allocator>::iterator vector<T, Allocator>::emplace(vector::const_iterator position, Args&&... args)
+typename vector<T, Allocator, GrowthPolicy>::iterator vector<T, Allocator, GrowthPolicy>::emplace(vector::const_iterator position, Args&&... args)
 {
     shift_right(position);
     std::allocator_traits<Allocator>::construct(allocator_, data_ + position.pos_, std::forward<Args&&>(args)...);
@@ -477,8 +529,8 @@ typename vector<T, Allocator>::iterator vector<T, Allocator>::emplace(vector::co
     return iterator(data_, size_, position.pos_);
 }
 
-template<class T, class Allocator>
-typename vector<T, Allocator>::iterator vector<T, Allocator>::insert(vector::const_iterator position, const T& elem)
+template<class T, class Allocator, class GrowthPolicy>
+typename vector<T, Allocator, GrowthPolicy>::iterator vector<T, Allocator, GrowthPolicy>::insert(vector::const_iterator position, const T& elem)
 {
     shift_right(position);
     std::allocator_traits<Allocator>::construct(allocator_, data_ + position.pos_, std::forward<const T&>(elem));
@@ -486,8 +538,8 @@ typename vector<T, Allocator>::iterator vector<T, Allocator>::insert(vector::con
     return iterator(data_, size_, position.pos_);
 }
 
-template<class T, class Allocator>
-typename vector<T, Allocator>::iterator vector<T, Allocator>::insert(vector::const_iterator position, T&& elem)
+template<class T, class Allocator, class GrowthPolicy>
+typename vector<T, Allocator, GrowthPolicy>::iterator vector<T, Allocator, GrowthPolicy>::insert(vector::const_iterator position, T&& elem)
 {
     shift_right(position);
     std::allocator_traits<Allocator>::construct(allocator_, data_ + position.pos_, std::forward<T&&>(elem));
@@ -495,8 +547,8 @@ typename vector<T, Allocator>::iterator vector<T, Allocator>::insert(vector::con
     return iterator(data_, size_, position.pos_);
 }
 
-template<class T, class Allocator>
-typename vector<T, Allocator>::iterator vector<T, Allocator>::insert(vector::const_iterator position,
+template<class T, class Allocator, class GrowthPolicy>
+typename vector<T, Allocator, GrowthPolicy>::iterator vector<T, Allocator, GrowthPolicy>::insert(vector::const_iterator position,
                                                                      vector::size_type n, const T& elem)
 {
     shift_right(position, n);
@@ -509,10 +561,10 @@ typename vector<T, Allocator>::iterator vector<T, Allocator>::insert(vector::con
     return iterator(data_, size_, position.pos_);
 }
 
-template<class T, class Allocator>
+template<class T, class Allocator, class GrowthPolicy>
 template<class InputIterator, class>
-typename vector<T, Allocator>::iterator
-vector<T, Allocator>::insert(vector::const_iterator position, InputIterator first, InputIterator last)
+typename vector<T, Allocator, GrowthPolicy>::iterator
+vector<T, Allocator, GrowthPolicy>::insert(vector::const_iterator position, InputIterator first, InputIterator last)
 {
     size_type size = last - first;
     shift_right(position, size);
@@ -527,14 +579,14 @@ vector<T, Allocator>::insert(vector::const_iterator position, InputIterator firs
     return iterator(data_, size_, position.pos_);
 }
 
-template<class T, class Allocator>
-typename vector<T, Allocator>::iterator vector<T, Allocator>::insert(vector::const_iterator position, std::initializer_list<T> ilist)
+template<class T, class Allocator, class GrowthPolicy>
+typename vector<T, Allocator, GrowthPolicy>::iterator vector<T, Allocator, GrowthPolicy>::insert(vector::const_iterator position, std::initializer_list<T> ilist)
 {
     return insert(position, ilist.begin(), ilist.end());
 }
 
-template<class T, class Allocator>
-typename vector<T, Allocator>::iterator vector<T, Allocator>::erase(vector::const_iterator position)
+template<class T, class Allocator, class GrowthPolicy>
+typename vector<T, Allocator, GrowthPolicy>::iterator vector<T, Allocator, GrowthPolicy>::erase(vector::const_iterator position)
 {
     if (empty()) {
         return iterator(data_, size_, size_);
@@ -546,8 +598,8 @@ typename vector<T, Allocator>::iterator vector<T, Allocator>::erase(vector::cons
 }
 
 
-template<class T, class Allocator>
-typename vector<T, Allocator>::iterator vector<T, Allocator>::erase(vector::const_iterator first, vector::const_iterator last)
+template<class T, class Allocator, class GrowthPolicy>
+typename vector<T, Allocator, GrowthPolicy>::iterator vector<T, Allocator, GrowthPolicy>::erase(vector::const_iterator first, vector::const_iterator last)
 {
     if (empty()) {
         return iterator(data_, size_, size_);
@@ -559,8 +611,195 @@ typename vector<T, Allocator>::iterator vector<T, Allocator>::erase(vector::cons
     return iterator(data_, size_, last.pos_ - (last - first));
 }
 
-template<class T, class Allocator>
-void vector<T, Allocator>::swap(vector<T, Allocator>& other)
+template<class T, class Allocator, class GrowthPolicy>
+typename vector<T, Allocator, GrowthPolicy>::iterator vector<T, Allocator, GrowthPolicy>::unordered_erase(vector::const_iterator position)
+{
+    if (static_cast<size_type>(position.pos_) + 1 != size_) {
+        data_[position.pos_] = std::move(data_[size_ - 1]);
+    }
+    pop_back();
+
+    return iterator(data_, size_, position.pos_);
+}
+
+template<class T, class Allocator, class GrowthPolicy>
+template<class Predicate>
+typename vector<T, Allocator, GrowthPolicy>::size_type vector<T, Allocator, GrowthPolicy>::unordered_erase_if(Predicate pred)
+{
+    auto old_size = size_;
+    for (size_type i = 0; i < size_;) {
+        if (pred(data_[i])) {
+            //the element moved in from the back is tested on the next iteration
+            if (i + 1 != size_) {
+                data_[i] = std::move(data_[size_ - 1]);
+            }
+            pop_back();
+        } else {
+            i++;
+        }
+    }
+
+    return old_size - size_;
+}
+
+//Walks the indices from the back, so the element pulled in from the end is never one still to be erased.
+template<class T, class Allocator, class GrowthPolicy>
+template<class BidirectionalIterator>
+typename vector<T, Allocator, GrowthPolicy>::size_type
+vector<T, Allocator, GrowthPolicy>::unordered_erase_indices(BidirectionalIterator first, BidirectionalIterator last)
+{
+    auto old_size = size_;
+    while (first != last) {
+        --last;
+        auto index = static_cast<size_type>(*last);
+        if (index + 1 != size_) {
+            data_[index] = std::move(data_[size_ - 1]);
+        }
+        pop_back();
+    }
+
+    return old_size - size_;
+}
+
+template<class T, class Allocator, class GrowthPolicy>
+typename vector<T, Allocator, GrowthPolicy>::size_type vector<T, Allocator, GrowthPolicy>::unordered_erase_indices(std::initializer_list<size_type> indices)
+{
+    return unordered_erase_indices(indices.begin(), indices.end());
+}
+
+//Relocates each run of old elements straight to its final slot and constructs the new values
+//in the holes between runs. Growth happens in one allocation: the new values are constructed
+//first, while a throw can still be undone, then the old runs are relocated around them.
+//Otherwise the runs are shifted in place from the back so no live element is overwritten, and
+//a throw closes the hole left in front of the shifted elements.
+template<class T, class Allocator, class GrowthPolicy>
+template<class PositionIterator, class InputIterator>
+void vector<T, Allocator, GrowthPolicy>::insert_many(PositionIterator positions_first, PositionIterator positions_last, InputIterator values_first)
+{
+    static_assert(std::is_nothrow_move_constructible<T>::value || is_trivially_relocatable_v<T>,
+                  "insert_many relocates elements and needs moves that cannot throw");
+
+    auto count = static_cast<size_type>(std::distance(positions_first, positions_last));
+    if (count == 0) {
+        return;
+    }
+
+    auto new_size = size_ + count;
+
+    if (new_size > capacity_) {
+        auto capacity   = GrowthPolicy::round_capacity(GrowthPolicy::next_capacity(capacity_, new_size), sizeof(T));
+        auto allocation = atl::allocate_at_least(allocator_, capacity);
+
+        size_type inserted = 0;
+        try {
+            auto value = values_first;
+            for (auto it = positions_first; it != positions_last; ++it, ++value, ++inserted) {
+                std::allocator_traits<Allocator>::construct(allocator_, allocation.ptr + static_cast<size_type>(*it) + inserted, *value);
+            }
+        } catch (...) {
+            auto it = positions_first;
+            for (size_type i = 0; i < inserted; ++it, ++i) {
+                std::allocator_traits<Allocator>::destroy(allocator_, allocation.ptr + static_cast<size_type>(*it) + i);
+            }
+            std::allocator_traits<Allocator>::deallocate(allocator_, allocation.ptr, allocation.count);
+            throw;
+        }
+
+        size_type done = 0;
+        inserted = 0;
+        for (auto it = positions_first; it != positions_last; ++it, ++inserted) {
+            auto position = static_cast<size_type>(*it);
+            atl::relocate(allocator_, data_ + done, position - done, allocation.ptr + done + inserted);
+            done = position;
+        }
+        atl::relocate(allocator_, data_ + done, size_ - done, allocation.ptr + done + inserted);
+
+        if (data_ != nullptr) {
+            std::allocator_traits<Allocator>::deallocate(allocator_, data_, capacity_);
+        }
+        data_ = allocation.ptr;
+        capacity_ = allocation.count;
+        size_ = new_size;
+        return;
+    }
+
+    auto value = values_first;
+    std::advance(value, count);
+    size_type done = size_;
+    size_type remaining = count;
+    for (auto it = positions_last; it != positions_first;) {
+        --it;
+        --value;
+        auto position = static_cast<size_type>(*it);
+        atl::relocate_overlapping(allocator_, data_ + position, done - position, data_ + position + remaining);
+        try {
+            std::allocator_traits<Allocator>::construct(allocator_, data_ + position + remaining - 1, *value);
+        } catch (...) {
+            //[position, position + remaining) is the only hole left
+            atl::relocate_overlapping(allocator_, data_ + position + remaining, new_size - position - remaining, data_ + position);
+            size_ = new_size - remaining;
+            throw;
+        }
+        --remaining;
+        done = position;
+    }
+    size_ = new_size;
+}
+
+template<class T, class Allocator, class GrowthPolicy>
+void vector<T, Allocator, GrowthPolicy>::insert_many(std::initializer_list<size_type> positions, std::initializer_list<T> values)
+{
+    if (positions.size() != values.size()) {
+        throw std::invalid_argument("insert_many needs one value per position");
+    }
+    insert_many(positions.begin(), positions.end(), values.begin());
+}
+
+//Destroys the erased elements and closes each hole by relocating the following run once.
+template<class T, class Allocator, class GrowthPolicy>
+template<class IndexIterator>
+typename vector<T, Allocator, GrowthPolicy>::size_type vector<T, Allocator, GrowthPolicy>::erase_indices(IndexIterator first, IndexIterator last)
+{
+    static_assert(std::is_nothrow_move_constructible<T>::value || is_trivially_relocatable_v<T>,
+                  "erase_indices relocates elements and needs moves that cannot throw");
+
+    if (first == last) {
+        return 0;
+    }
+
+    auto write = static_cast<size_type>(*first);
+    for (auto it = first; it != last;) {
+        auto index = static_cast<size_type>(*it);
+        std::allocator_traits<Allocator>::destroy(allocator_, data_ + index);
+
+        auto next = ++it == last ? size_ : static_cast<size_type>(*it);
+        atl::relocate_overlapping(allocator_, data_ + index + 1, next - index - 1, data_ + write);
+        write += next - index - 1;
+    }
+
+    auto removed = size_ - write;
+    size_ = write;
+    return removed;
+}
+
+template<class T, class Allocator, class GrowthPolicy>
+typename vector<T, Allocator, GrowthPolicy>::size_type vector<T, Allocator, GrowthPolicy>::erase_indices(std::initializer_list<size_type> indices)
+{
+    return erase_indices(indices.begin(), indices.end());
+}
+
+template<class T, class Allocator, class GrowthPolicy>
+void vector<T, Allocator, GrowthPolicy>::swap(vector<T, Allocator, GrowthPolicy>& other) noexcept
+{
+    if constexpr (std::allocator_traits<Allocator>::propagate_on_container_swap::value) {
+        using std::swap;
+        swap(allocator_, other.allocator_);
+    }
+    swap_storage(other);
+}
+
+template<class T, class Allocator, class GrowthPolicy>
+void vector<T, Allocator, GrowthPolicy>::swap_storage(vector& other) noexcept
 {
     std::swap(data_, other.data_);
     std::swap(size_, other.size_);
@@ -568,17 +807,42 @@ void vector<T, Allocator>::swap(vector<T, Allocator>& other)
 }
 
 
-template<class T, class Allocator>
-void vector<T, Allocator>::move_to_another_ptr(vector::pointer new_data)
+template<class T, class Allocator, class GrowthPolicy>
+void vector<T, Allocator, GrowthPolicy>::reallocate(vector::size_type capacity)
 {
-    for (size_type i = 0; i < size_; i++) {
-        std::allocator_traits<Allocator>::construct(allocator_, new_data + i, std::move(data_[i]));
-        std::allocator_traits<Allocator>::destroy(allocator_, data_ + i);
+    capacity = GrowthPolicy::round_capacity(capacity, sizeof(T));
+
+    //try to resize the block in place (realloc/mremap) before falling back to copy-and-free
+    if constexpr (is_trivially_relocatable_v<T> && has_reallocate_v<Allocator>) {
+        if (data_ != nullptr && capacity != 0) {
+            auto resized = atl::reallocate_at_least(allocator_, data_, capacity_, capacity);
+            if (resized.ptr != nullptr) {
+                data_ = resized.ptr;
+                capacity_ = resized.count;
+                return;
+            }
+        }
     }
+
+    auto allocation = atl::allocate_at_least(allocator_, capacity);
+    move_to_another_ptr(allocation.ptr);
+
+    if (data_ != nullptr) {
+        std::allocator_traits<Allocator>::deallocate(allocator_, data_, capacity_);
+    }
+    data_= allocation.ptr;
+    capacity_ = allocation.count;
+}
+
+template<class T, class Allocator, class GrowthPolicy>
+void vector<T, Allocator, GrowthPolicy>::move_to_another_ptr(vector::pointer new_data)
+{
+    atl::relocate(allocator_, data_, size_, new_data);
 }
 
-template<class T, class Allocator>
-void vector<T, Allocator>::copy_from_another_vector(const vector<T>& other)
+template<class T, class Allocator, class GrowthPolicy>
+template<class OtherAllocator, class OtherGrowthPolicy>
+void vector<T, Allocator, GrowthPolicy>::copy_from_another_vector(const vector<T, OtherAllocator, OtherGrowthPolicy>& other)
 {
     int i = 0;
     for (const auto& val : other) {
@@ -587,166 +851,166 @@ void vector<T, Allocator>::copy_from_another_vector(const vector<T>& other)
     }
 }
 
-template<class T, class Allocator>
-void vector<T, Allocator>::reserve_for_push(vector::difference_type size)
+template<class T, class Allocator, class GrowthPolicy>
+void vector<T, Allocator, GrowthPolicy>::reserve_for_push(vector::difference_type size)
 {
     auto needed_capacity = size_ + size;
 
-    if (capacity_  > needed_capacity) {
+    if (capacity_ >= needed_capacity) {
         return;
     }
 
-    size_type new_capacity;
-
-    if (size == 1) {
-        if (capacity_ == 0) {
-            capacity_ = MIN_CAPACITY;
-        } else {
-            new_capacity = static_cast<size_type>(std::floor(capacity_ * INCREASE_CAPACITY_FACTOR));
-        }
-    } else {
-        new_capacity = needed_capacity;
-    }
-
-    reserve(new_capacity);
+    reserve(GrowthPolicy::next_capacity(capacity_, needed_capacity));
 }
 
-template<class T, class Allocator>
-void vector<T, Allocator>::shrink_to_fit()
+template<class T, class Allocator, class GrowthPolicy>
+void vector<T, Allocator, GrowthPolicy>::shrink_to_fit()
 {
     if (capacity_ == size_) {
         return;
     }
 
-    auto new_data = std::allocator_traits<Allocator>::allocate(allocator_, size_);
-    move_to_another_ptr(new_data);
-    std::allocator_traits<Allocator>::deallocate(allocator_, data_, capacity_);
-    data_= new_data;
-    capacity_ = size_;
+    reallocate(size_);
 }
 
-template<class T, class Allocator>
+template<class T, class Allocator, class GrowthPolicy>
 template<class... Args>
-void vector<T, Allocator>::emplace_back(Args&& ...args)
+void vector<T, Allocator, GrowthPolicy>::emplace_back(Args&& ...args)
 {
     reserve_for_push();
     std::allocator_traits<Allocator>::construct(allocator_, data_ + size_, std::forward<Args&&>(args)...);
     size_++;
 }
 
-template<class T, class Allocator>
-void vector<T, Allocator>::clear() noexcept
+template<class T, class Allocator, class GrowthPolicy>
+void vector<T, Allocator, GrowthPolicy>::clear() noexcept
 {
     resize(0);
 }
 
-template<class T, class Allocator>
-typename vector<T,Allocator>::iterator vector<T, Allocator>::begin() noexcept
+template<class T, class Allocator, class GrowthPolicy>
+typename vector<T, Allocator, GrowthPolicy>::iterator vector<T, Allocator, GrowthPolicy>::begin() noexcept
 {
     return iterator(data_, size_);
 }
 
-template<class T, class Allocator>
-typename vector<T, Allocator>::const_iterator vector<T, Allocator>::begin() const noexcept
+template<class T, class Allocator, class GrowthPolicy>
+typename vector<T, Allocator, GrowthPolicy>::const_iterator vector<T, Allocator, GrowthPolicy>::begin() const noexcept
 {
     return const_iterator(data_, size_);
 }
 
-template<class T, class Allocator>
-typename vector<T, Allocator>::iterator vector<T, Allocator>::end() noexcept
+template<class T, class Allocator, class GrowthPolicy>
+typename vector<T, Allocator, GrowthPolicy>::iterator vector<T, Allocator, GrowthPolicy>::end() noexcept
 {
     return iterator(data_, size_, size_);
 }
 
-template<class T, class Allocator>
-typename vector<T, Allocator>::const_iterator vector<T, Allocator>::end() const noexcept
+template<class T, class Allocator, class GrowthPolicy>
+typename vector<T, Allocator, GrowthPolicy>::const_iterator vector<T, Allocator, GrowthPolicy>::end() const noexcept
 {
     return const_iterator(data_, size_, size_);
 }
 
-template<class T, class Allocator>
-typename vector<T, Allocator>::reverse_iterator vector<T, Allocator>::rbegin() noexcept
+template<class T, class Allocator, class GrowthPolicy>
+typename vector<T, Allocator, GrowthPolicy>::reverse_iterator vector<T, Allocator, GrowthPolicy>::rbegin() noexcept
 {
     return reverse_iterator(end());
 }
 
-template<class T, class Allocator>
-typename vector<T, Allocator>::const_reverse_iterator vector<T, Allocator>::rbegin() const noexcept
+template<class T, class Allocator, class GrowthPolicy>
+typename vector<T, Allocator, GrowthPolicy>::const_reverse_iterator vector<T, Allocator, GrowthPolicy>::rbegin() const noexcept
 {
     return const_reverse_iterator(end());
 }
 
-template<class T, class Allocator>
-typename vector<T, Allocator>::reverse_iterator vector<T, Allocator>::rend() noexcept
+template<class T, class Allocator, class GrowthPolicy>
+typename vector<T, Allocator, GrowthPolicy>::reverse_iterator vector<T, Allocator, GrowthPolicy>::rend() noexcept
 {
     return reverse_iterator(begin());
 }
 
-template<class T, class Allocator>
-typename vector<T, Allocator>::const_reverse_iterator vector<T, Allocator>::rend() const noexcept
+template<class T, class Allocator, class GrowthPolicy>
+typename vector<T, Allocator, GrowthPolicy>::const_reverse_iterator vector<T, Allocator, GrowthPolicy>::rend() const noexcept
 {
     return const_reverse_iterator(begin());
 }
 
-template<class T, class Allocator>
-typename vector<T, Allocator>::const_iterator vector<T, Allocator>::cbegin() noexcept
+template<class T, class Allocator, class GrowthPolicy>
+typename vector<T, Allocator, GrowthPolicy>::const_iterator vector<T, Allocator, GrowthPolicy>::cbegin() noexcept
 {
     return const_iterator(data_, size_);
 }
 
-template<class T, class Allocator>
-typename vector<T, Allocator>::const_iterator vector<T, Allocator>::cend() noexcept
+template<class T, class Allocator, class GrowthPolicy>
+typename vector<T, Allocator, GrowthPolicy>::const_iterator vector<T, Allocator, GrowthPolicy>::cend() noexcept
 {
     return const_iterator(data_, size_, size_);
 }
 
-template<class T, class Allocator>
-typename vector<T, Allocator>::const_reverse_iterator vector<T, Allocator>::crbegin() const noexcept
+template<class T, class Allocator, class GrowthPolicy>
+typename vector<T, Allocator, GrowthPolicy>::const_reverse_iterator vector<T, Allocator, GrowthPolicy>::crbegin() const noexcept
 {
     return const_reverse_iterator(end());
 }
 
-template<class T, class Allocator>
-typename vector<T, Allocator>::const_reverse_iterator vector<T, Allocator>::crend() const noexcept
+template<class T, class Allocator, class GrowthPolicy>
+typename vector<T, Allocator, GrowthPolicy>::const_reverse_iterator vector<T, Allocator, GrowthPolicy>::crend() const noexcept
 {
     return const_reverse_iterator(begin());
 }
 
 
-template<class T, class Allocator>
-void vector<T, Allocator>::assign(vector::size_type n, const T& elem)
+template<class T, class Allocator, class GrowthPolicy>
+void vector<T, Allocator, GrowthPolicy>::assign(vector::size_type n, const T& elem)
 {
-    destruct_data();
-    reserve(n);
-
-    for (size_type i = 0; i < n; i++) {
-        std::allocator_traits<Allocator>::construct(allocator_, data_ + i, elem);
+    if (n > capacity_) {
+        //elem may live in the buffer that is about to be dropped
+        T value(elem);
+        clear_for_capacity(n);
+        assign(n, value);
+        return;
     }
 
+    std::fill_n(data_, std::min(n, size_), elem);
+    for (; size_ < n; size_++) {
+        std::allocator_traits<Allocator>::construct(allocator_, data_ + size_, elem);
+    }
+    destruct_data(n);
     size_ = n;
 }
 
-template<class T, class Allocator>
+template<class T, class Allocator, class GrowthPolicy>
 template<class InputIterator, class>
-void vector<T, Allocator>::assign(InputIterator first, InputIterator last)
+void vector<T, Allocator, GrowthPolicy>::assign(InputIterator first, InputIterator last)
 {
-    destruct_data();
     auto size = static_cast<size_type>(std::distance(first, last));
-    reserve(size);
 
-    fill_from_iterator(first, last);
+    if (size > capacity_) {
+        clear_for_capacity(size);
+    }
+
+    //assign over live elements, construct or destroy only the difference
+    size_type i = 0;
+    for (; i < size && i < size_; i++, first++) {
+        data_[i] = *first;
+    }
+    for (; size_ < size; size_++, first++) {
+        std::allocator_traits<Allocator>::construct(allocator_, data_ + size_, *first);
+    }
+    destruct_data(size);
     size_ = size;
 }
 
-template<class T, class Allocator>
-void vector<T, Allocator>::assign(std::initializer_list<T> init_list)
+template<class T, class Allocator, class GrowthPolicy>
+void vector<T, Allocator, GrowthPolicy>::assign(std::initializer_list<T> init_list)
 {
     assign(init_list.begin(), init_list.end());
 }
 
-template<class T, class Allocator>
+template<class T, class Allocator, class GrowthPolicy>
 template<class It, class>
-void vector<T, Allocator>::fill_from_iterator(It first, It last)
+void vector<T, Allocator, GrowthPolicy>::fill_from_iterator(It first, It last)
 {
     size_type i =  0;
     for (auto it = first; it != last; it++, i++) {
@@ -754,149 +1018,269 @@ void vector<T, Allocator>::fill_from_iterator(It first, It last)
     }
 }
 
-template<class T, class Allocator>
-vector<T, Allocator>& vector<T, Allocator>::operator=(const vector<T, Allocator>& rhs)
+template<class T, class Allocator, class GrowthPolicy>
+vector<T, Allocator, GrowthPolicy>& vector<T, Allocator, GrowthPolicy>::operator=(const vector<T, Allocator, GrowthPolicy>& rhs)
 {
-    deallocate_data();
-    allocator_ = rhs.allocator_;
-    capacity_  = rhs.capacity_;
-    size_      = rhs.size_;
+    if (this == &rhs) {
+        return *this;
+    }
 
-    data_ = std::allocator_traits<Allocator>::allocate(allocator_, rhs.capacity());
-    copy_from_another_vector(rhs);
+    if constexpr (std::allocator_traits<Allocator>::propagate_on_container_copy_assignment::value) {
+        //the current buffer can only be reused if the incoming allocator could free it
+        if (!(allocator_ == rhs.allocator_)) {
+            deallocate_data();
+            data_     = nullptr;
+            size_     = 0;
+            capacity_ = 0;
+        }
+        allocator_ = rhs.allocator_;
+    }
 
+    assign(rhs.begin(), rhs.end());
     return *this;
 }
 
-template<class T, class Allocator>
-vector<T, Allocator>& vector<T, Allocator>::operator=(vector<T, Allocator>&& rhs) noexcept
+template<class T, class Allocator, class GrowthPolicy>
+vector<T, Allocator, GrowthPolicy>& vector<T, Allocator, GrowthPolicy>::operator=(vector<T, Allocator, GrowthPolicy>&& rhs)
+        noexcept(std::allocator_traits<Allocator>::propagate_on_container_move_assignment::value ||
+                 std::allocator_traits<Allocator>::is_always_equal::value)
 {
+    if (this == &rhs) {
+        return *this;
+    }
+
+    //memory from an unequal, non-propagating allocator can't be adopted: move element-wise
+    if constexpr (!std::allocator_traits<Allocator>::propagate_on_container_move_assignment::value) {
+        if (!(allocator_ == rhs.allocator_)) {
+            assign(std::make_move_iterator(rhs.begin()), std::make_move_iterator(rhs.end()));
+            rhs.clear();
+            return *this;
+        }
+    }
+
     deallocate_data();
-    allocator_ = std::move(rhs.allocator_);
-    capacity_  = rhs.capacity_;
-    size_      = rhs.size_;
+    data_     = nullptr;
+    size_     = 0;
+    capacity_ = 0;
 
-    data_ = std::move(rhs.data_);
+    if constexpr (std::allocator_traits<Allocator>::propagate_on_container_move_assignment::value) {
+        allocator_ = std::move(rhs.allocator_);
+    }
+    swap_storage(rhs);
 
     return *this;
 }
 
 //ATTENTION leaves container in non-consistent state
-template<class T, class Allocator>
-void vector<T, Allocator>::deallocate_data()
+template<class T, class Allocator, class GrowthPolicy>
+void vector<T, Allocator, GrowthPolicy>::deallocate_data()
 {
     for (size_type i = 0; i < size_; i++) {
         std::allocator_traits<Allocator>::destroy(allocator_, data_ + i);
     }
-    std::allocator_traits<Allocator>::deallocate(allocator_, data_, capacity_);
+    if (data_ != nullptr) {
+        std::allocator_traits<Allocator>::deallocate(allocator_, data_, capacity_);
+    }
 }
 
-template<class T, class Allocator>
-vector<T, Allocator>& vector<T, Allocator>::operator=(std::initializer_list<T> ilist)
+template<class T, class Allocator, class GrowthPolicy>
+vector<T, Allocator, GrowthPolicy>& vector<T, Allocator, GrowthPolicy>::operator=(std::initializer_list<T> ilist)
 {
     assign(std::move(ilist));
     return *this;
 }
 
-template<class T, class Allocator>
-void vector<T, Allocator>::destruct_data(size_type from)
+//drops all elements and makes room for at least capacity of them without copying anything over
+//(a fresh block rather than reallocate, which would carry the dead contents along)
+template<class T, class Allocator, class GrowthPolicy>
+void vector<T, Allocator, GrowthPolicy>::clear_for_capacity(size_type capacity)
+{
+    deallocate_data();
+    data_ = nullptr;
+    size_ = 0;
+    capacity_ = 0;
+
+    auto allocation = atl::allocate_at_least(allocator_, GrowthPolicy::round_capacity(capacity, sizeof(T)));
+    data_ = allocation.ptr;
+    capacity_ = allocation.count;
+}
+
+template<class T, class Allocator, class GrowthPolicy>
+void vector<T, Allocator, GrowthPolicy>::destruct_data(size_type from)
 {
     for (size_type i = from; i < size_; i++) {
         std::allocator_traits<Allocator>::destroy(allocator_, data_ + i);
     }
 }
 
-template<class T, class Allocator>
-void vector<T, Allocator>::shift_right(vector::const_iterator pos, vector::difference_type distance)
+//Opens an uninitialized gap of `distance` slots at pos, growing the buffer if needed.
+template<class T, class Allocator, class GrowthPolicy>
+void vector<T, Allocator, GrowthPolicy>::shift_right(vector::const_iterator pos, vector::difference_type distance)
 {
     reserve_for_push(distance);
 
-    for (auto it = end() + distance - 1; it != pos + distance - 1; it--) {
-        std::allocator_traits<Allocator>::construct(allocator_, &*it, std::move(*(it-distance)));
-        std::allocator_traits<Allocator>::destroy(allocator_, &*(it-distance));
+    size_type index = pos.pos_;
+    size_type tail  = size_ - index;
+
+    if (tail == 0 || distance == 0) {
+        return;
+    }
+
+    if constexpr (is_trivially_relocatable_v<T>) {
+        std::memmove(static_cast<void*>(std::addressof(*(data_ + index + distance))),
+                     static_cast<const void*>(std::addressof(*(data_ + index))),
+                     tail * sizeof(T));
+    } else if (tail > static_cast<size_type>(distance)) {
+        //the last `distance` elements move into raw storage, the rest shift by move-assignment
+        for (size_type i = size_ - distance; i < size_; i++) {
+            std::allocator_traits<Allocator>::construct(allocator_, data_ + i + distance, std::move(data_[i]));
+        }
+        std::move_backward(data_ + index, data_ + size_ - distance, data_ + size_);
+        for (size_type i = index; i < index + distance; i++) {
+            std::allocator_traits<Allocator>::destroy(allocator_, data_ + i);
+        }
+    } else {
+        for (size_type i = index; i < size_; i++) {
+            std::allocator_traits<Allocator>::construct(allocator_, data_ + i + distance, std::move(data_[i]));
+            std::allocator_traits<Allocator>::destroy(allocator_, data_ + i);
+        }
     }
 }
 
-template<class T, class Allocator>
-void vector<T, Allocator>::shift_left(vector::const_iterator pos, vector::difference_type distance)
+//Removes the `distance` elements preceding pos, closing the gap with the tail.
+template<class T, class Allocator, class GrowthPolicy>
+void vector<T, Allocator, GrowthPolicy>::shift_left(vector::const_iterator pos, vector::difference_type distance)
 {
     if (distance == 0) {
         return;
     }
 
-    for (auto it = pos - distance; it != end() - distance; it++) {
-        std::allocator_traits<Allocator>::destroy(allocator_, &*it);
-        std::allocator_traits<Allocator>::construct(allocator_, &*it, std::move(*(it+distance)));
-        std::allocator_traits<Allocator>::destroy(allocator_, &*(it+distance));
-    }
+    size_type index = pos.pos_;
+    size_type tail  = size_ - index;
 
-    for (auto it = end() - distance; it != end(); it++) {
-        std::allocator_traits<Allocator>::destroy(allocator_, &*it);
+    if constexpr (is_trivially_relocatable_v<T>) {
+        for (size_type i = index - distance; i < index; i++) {
+            std::allocator_traits<Allocator>::destroy(allocator_, data_ + i);
+        }
+        if (tail != 0) {
+            std::memmove(static_cast<void*>(std::addressof(*(data_ + index - distance))),
+                         static_cast<const void*>(std::addressof(*(data_ + index))),
+                         tail * sizeof(T));
+        }
+    } else {
+        std::move(data_ + index, data_ + size_, data_ + index - distance);
+        for (size_type i = size_ - distance; i < size_; i++) {
+            std::allocator_traits<Allocator>::destroy(allocator_, data_ + i);
+        }
     }
 }
 
 
-template<class U, class UAllocator>
-bool operator==(const vector<U, UAllocator>& lhs, const vector<U, UAllocator>& rhs)
+template <class T, class Allocator, class GrowthPolicy>
+void swap(vector<T, Allocator, GrowthPolicy>& lhs, vector<T, Allocator, GrowthPolicy>& rhs) noexcept
 {
-    if (lhs.size_ != rhs.size_) {
-        return false;
-    }
+    lhs.swap(rhs);
+}
 
-    auto itL = lhs.begin();
-    auto itR = rhs.begin();
+namespace detail {
 
-    for (;itL != lhs.end(); itL++, itR++) {
-        if (*itL != *itR) {
-            return false;
+//Moves the elements of [first, last) not matching pred to the front, preserving their order.
+//Returns the new end; the elements past it are left moved-from.
+template <class T, class Predicate>
+T* compact(T* first, T* last, Predicate& pred)
+{
+    if constexpr (std::is_arithmetic<T>::value) {
+        //branchless: always store, advance the write cursor only for survivors, so randomly
+        //scattered tombstones cost no mispredictions
+        auto out = first;
+        for (auto it = first; it != last; ++it) {
+            auto value = *it;
+            *out = value;
+            out += !pred(value);
+        }
+        return out;
+    } else {
+        auto out = std::find_if(first, last, pred);
+        if (out == last) {
+            return last;
+        }
+        for (auto it = out + 1; it != last; ++it) {
+            if (!pred(*it)) {
+                *out = std::move(*it);
+                ++out;
+            }
         }
+        return out;
     }
+}
 
-    return true;
+} //namespace detail
+
+//Removes every element matching pred in a single pass and returns how many were removed.
+template <class T, class Allocator, class GrowthPolicy, class Predicate>
+typename vector<T, Allocator, GrowthPolicy>::size_type erase_if(vector<T, Allocator, GrowthPolicy>& c, Predicate pred)
+{
+    if (c.empty()) {
+        return 0;
+    }
+
+    auto first = std::addressof(*c.data());
+    auto last  = first + c.size();
+    auto removed = static_cast<typename vector<T, Allocator, GrowthPolicy>::size_type>(last - detail::compact(first, last, pred));
+
+    c.erase(c.end() - removed, c.end());
+    return removed;
 }
 
-template<class U, class UAllocator>
-bool operator<(const vector<U, UAllocator>& lhs, const vector<U, UAllocator>& rhs)
+template <class T, class Allocator, class GrowthPolicy, class U>
+typename vector<T, Allocator, GrowthPolicy>::size_type erase(vector<T, Allocator, GrowthPolicy>& c, const U& value)
 {
-    auto size = std::min(lhs.size(), rhs.size());
+    return erase_if(c, [&value](const T& elem) { return elem == value; });
+}
 
-    for (typename vector<U, UAllocator>::size_type i = 0; i < size; i++) {
-        if (lhs[i] < rhs[i]) {
-            return true;
-        }
-    }
-    return lhs.size() < rhs.size();
+template<class U, class UAllocator, class UGrowthPolicy>
+bool operator==(const vector<U, UAllocator, UGrowthPolicy>& lhs, const vector<U, UAllocator, UGrowthPolicy>& rhs)
+{
+    //one memcmp for trivially equality comparable U, element-wise otherwise
+    return lhs.size_ == rhs.size_ && detail::equal_n(lhs.data_, rhs.data_, lhs.size_);
 }
 
-template<class U, class UAllocator>
-bool operator!=(const vector<U, UAllocator>& lhs, const vector<U, UAllocator>& rhs)
+//lexicographic, by operator< of the elements; see detail::compare_n for the fast paths
+template<class U, class UAllocator, class UGrowthPolicy>
+bool operator<(const vector<U, UAllocator, UGrowthPolicy>& lhs, const vector<U, UAllocator, UGrowthPolicy>& rhs)
 {
-    return !(lhs == rhs);
+    return detail::compare_n(lhs.data_, lhs.size_, rhs.data_, rhs.size_) < 0;
 }
 
-template<class U, class UAllocator>
-bool operator> (const vector<U, UAllocator>& lhs, const vector<U, UAllocator>& rhs)
+template<class U, class UAllocator, class UGrowthPolicy>
+bool operator!=(const vector<U, UAllocator, UGrowthPolicy>& lhs, const vector<U, UAllocator, UGrowthPolicy>& rhs)
 {
-    return rhs < lhs;
+    return !(lhs == rhs);
 }
 
-template<class U, class UAllocator>
-bool operator>=(const vector<U, UAllocator>& lhs, const vector<U, UAllocator>& rhs)
+template<class U, class UAllocator, class UGrowthPolicy>
+bool operator> (const vector<U, UAllocator, UGrowthPolicy>& lhs, const vector<U, UAllocator, UGrowthPolicy>& rhs)
 {
-    return rhs <= lhs;
+    return detail::compare_n(lhs.data_, lhs.size_, rhs.data_, rhs.size_) > 0;
 }
 
-template<class U, class UAllocator>
-bool operator<=(const vector<U, UAllocator>& lhs, const vector<U, UAllocator>& rhs)
+template<class U, class UAllocator, class UGrowthPolicy>
+bool operator>=(const vector<U, UAllocator, UGrowthPolicy>& lhs, const vector<U, UAllocator, UGrowthPolicy>& rhs)
 {
-    auto size = std::min(lhs.size(), rhs.size());
+    return detail::compare_n(lhs.data_, lhs.size_, rhs.data_, rhs.size_) >= 0;
+}
 
-    for (typename vector<U, UAllocator>::size_type i = 0; i < size; i++) {
-        if (lhs[i] < rhs[i]) {
-            return true;
-        }
-    }
-    return lhs.size() == rhs.size();
+template<class U, class UAllocator, class UGrowthPolicy>
+bool operator<=(const vector<U, UAllocator, UGrowthPolicy>& lhs, const vector<U, UAllocator, UGrowthPolicy>& rhs)
+{
+    return detail::compare_n(lhs.data_, lhs.size_, rhs.data_, rhs.size_) <= 0;
 }
 
+namespace pmr {
+
+template <class T, class GrowthPolicy = default_growth_policy>
+using vector = atl::vector<T, std::pmr::polymorphic_allocator<T>, GrowthPolicy>;
+
+} //namespace pmr
+
 } //namespace atl
@@ -1,9 +1,10 @@
 #pragma once
 
 #include <memory>
+#include "growth_policy.h"
 
 namespace atl {
-    template <typename T, typename Allocator = std::allocator<T>> class vector;
+    template <typename T, typename Allocator = std::allocator<T>, typename GrowthPolicy = default_growth_policy> class vector;
 
 template <class T, bool is_const>
 class VectorIterator
@@ -55,8 +56,8 @@ public:
                                                    typename VectorIterator<U, is_const_u>::size_type);
 
     template <class U, bool is_const_u, class F, bool is_const_f>
-    friend typename VectorIterator<U, is_const_u>::difference_type operator-(VectorIterator<U, is_const_u>& lhs,
-                                                                             VectorIterator<F, is_const_f>& rhs);
+    friend typename VectorIterator<U, is_const_u>::difference_type operator-(const VectorIterator<U, is_const_u>& lhs,
+                                                                             const VectorIterator<F, is_const_f>& rhs);
 
     reference operator[](size_type) const;
 
@@ -80,7 +81,7 @@ private:
     difference_type size_;
     difference_type pos_;
 
-    friend vector<T>;
+    template <class, class, class> friend class vector;
     friend VectorIterator<T, !is_const>;
 };
 
@@ -193,8 +194,8 @@ VectorIterator<U, is_const_u> operator-(const VectorIterator<U, is_const_u>& lhs
 }
 
 template<class U, bool is_const_u, class F, bool is_const_f>
-typename VectorIterator<U, is_const_u>::difference_type operator-(VectorIterator<U, is_const_u>& lhs,
-                                                                  VectorIterator<F, is_const_f>& rhs)
+typename VectorIterator<U, is_const_u>::difference_type operator-(const VectorIterator<U, is_const_u>& lhs,
+                                                                  const VectorIterator<F, is_const_f>& rhs)
 {
     return lhs.pos_ - rhs.pos_;
 }
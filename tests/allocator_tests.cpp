@@ -0,0 +1,406 @@
+#include "catch.hpp"
+#include "vector.h"
+#include "malloc_allocator.h"
+#include "huge_page_allocator.h"
+#include "mmap_vector.h"
+#include <cstdint>
+#include <algorithm>
+#include <memory_resource>
+
+namespace {
+
+//malloc_allocator that counts in-place resizes and can be told to refuse them
+template <class T>
+struct counting_realloc_allocator : atl::malloc_allocator<T>
+{
+    template <class U> struct rebind { using other = counting_realloc_allocator<U>; };
+
+    counting_realloc_allocator() = default;
+    template <class U> counting_realloc_allocator(const counting_realloc_allocator<U>&) {}
+
+    T* reallocate(T* p, std::size_t old_n, std::size_t new_n) noexcept
+    {
+        ++calls;
+        return refuse ? nullptr : atl::malloc_allocator<T>::reallocate(p, old_n, new_n).ptr;
+    }
+
+    static inline int calls = 0;
+    static inline bool refuse = false;
+};
+
+}
+
+TEST_CASE("malloc_allocator", "[allocator]")
+{
+    SECTION("vector grows through reallocate")
+    {
+        REQUIRE(atl::has_reallocate_v<atl::malloc_allocator<int>>);
+        REQUIRE_FALSE(atl::has_reallocate_v<std::allocator<int>>);
+
+        atl::vector<int, atl::malloc_allocator<int>> test_vector;
+        for (int i = 0; i < 10000; i++) {
+            test_vector.push_back(i);
+        }
+
+        for (int i = 0; i < 10000; i++) {
+            REQUIRE(test_vector[i] == i);
+        }
+
+        //malloc may round the block up by a few bytes, which counts as capacity
+        test_vector.shrink_to_fit();
+        REQUIRE(test_vector.capacity() >= 10000);
+        REQUIRE(test_vector.capacity() < 10008);
+        REQUIRE(test_vector.back() == 9999);
+    }
+
+    SECTION("falls back to copy when reallocate fails")
+    {
+        using Alloc = counting_realloc_allocator<int>;
+        atl::vector<int, Alloc> test_vector = {1, 2, 3};
+
+        Alloc::calls = 0;
+        Alloc::refuse = true;
+        test_vector.reserve(1000);
+        REQUIRE(Alloc::calls == 1);
+        REQUIRE(test_vector.capacity() >= 1000);
+        REQUIRE(test_vector.capacity() < 1008);
+
+        Alloc::refuse = false;
+        test_vector.reserve(5000);
+        REQUIRE(Alloc::calls == 2);
+        REQUIRE(test_vector.capacity() == 5000);
+
+        REQUIRE(test_vector[0] == 1);
+        REQUIRE(test_vector[1] == 2);
+        REQUIRE(test_vector[2] == 3);
+    }
+
+    SECTION("assigning past capacity does not carry the old contents over")
+    {
+        using Alloc = counting_realloc_allocator<int>;
+        atl::vector<int, Alloc> test_vector = {1, 2, 3};
+
+        Alloc::calls = 0;
+        Alloc::refuse = false;
+        test_vector.assign(1000, 7);
+        REQUIRE(Alloc::calls == 0);
+        REQUIRE(test_vector.size() == 1000);
+        REQUIRE(test_vector.capacity() >= 1000);
+        REQUIRE(test_vector[999] == 7);
+    }
+
+    SECTION("non trivially relocatable types never use reallocate")
+    {
+        using Alloc = counting_realloc_allocator<std::string>;
+        atl::vector<std::string, Alloc> test_vector = {"a", "b"};
+
+        Alloc::calls = 0;
+        test_vector.reserve(100);
+        REQUIRE(Alloc::calls == 0);
+        REQUIRE(test_vector[1] == "b");
+    }
+}
+
+namespace {
+
+//hands out twice the requested number of elements
+template <class T>
+struct doubling_allocator : std::allocator<T>
+{
+    template <class U> struct rebind { using other = doubling_allocator<U>; };
+
+    doubling_allocator() = default;
+    template <class U> doubling_allocator(const doubling_allocator<U>&) {}
+
+    atl::allocation_result<T*> allocate_at_least(std::size_t n)
+    {
+        return {std::allocator<T>::allocate(2 * n), 2 * n};
+    }
+};
+
+//malloc_allocator whose in-place resizes always leave 64 spare elements
+template <class T>
+struct padded_realloc_allocator : atl::malloc_allocator<T>
+{
+    template <class U> struct rebind { using other = padded_realloc_allocator<U>; };
+
+    padded_realloc_allocator() = default;
+    template <class U> padded_realloc_allocator(const padded_realloc_allocator<U>&) {}
+
+    atl::allocation_result<T*> reallocate(T* p, std::size_t old_n, std::size_t new_n) noexcept
+    {
+        auto result = atl::malloc_allocator<T>::reallocate(p, old_n, new_n + 64);
+        return {result.ptr, new_n + 64};
+    }
+};
+
+}
+
+TEST_CASE("allocate_at_least", "[allocator]")
+{
+    SECTION("detection")
+    {
+        REQUIRE(atl::has_allocate_at_least_v<doubling_allocator<int>>);
+        REQUIRE(atl::has_allocate_at_least_v<atl::malloc_allocator<int>>);
+    }
+
+    SECTION("vector records the extra capacity")
+    {
+        atl::vector<int, doubling_allocator<int>> test_vector;
+        test_vector.reserve(100);
+        REQUIRE(test_vector.capacity() == 200);
+
+        for (int i = 0; i < 201; i++) {
+            test_vector.push_back(i);
+        }
+        REQUIRE(test_vector.capacity() == 600);
+        REQUIRE(test_vector[200] == 200);
+    }
+
+    SECTION("malloc slack becomes capacity")
+    {
+        atl::vector<char, atl::malloc_allocator<char>> test_vector;
+        test_vector.reserve(1);
+        REQUIRE(test_vector.capacity() >= 1);
+
+        auto data = test_vector.data();
+        auto capacity = test_vector.capacity();
+        for (std::size_t i = 0; i < capacity; i++) {
+            test_vector.push_back('a');
+        }
+        REQUIRE(test_vector.data() == data);
+    }
+
+    SECTION("reallocate reports the extra capacity of a grown buffer")
+    {
+        atl::vector<int, padded_realloc_allocator<int>> test_vector = {1, 2, 3};
+        test_vector.reserve(1000);
+        REQUIRE(test_vector.capacity() == 1064);
+
+        for (int i = 3; i < 1064; i++) {
+            test_vector.push_back(i);
+        }
+        REQUIRE(test_vector.capacity() == 1064);
+        REQUIRE(test_vector[2] == 3);
+        REQUIRE(test_vector[1063] == 1063);
+    }
+
+#if defined(__GLIBC__)
+    SECTION("malloc slack of a grown buffer becomes capacity")
+    {
+        atl::vector<int, atl::malloc_allocator<int>> test_vector = {1, 2, 3};
+        for (int i = 0; i < 5; i++) {
+            test_vector.reserve(test_vector.capacity() * 3 + 1);
+            REQUIRE(test_vector.capacity() == malloc_usable_size(test_vector.data()) / sizeof(int));
+        }
+        REQUIRE(test_vector[2] == 3);
+    }
+#endif
+}
+
+TEST_CASE("huge_page_allocator", "[allocator]")
+{
+    SECTION("small blocks come from the heap")
+    {
+        atl::vector<int, atl::huge_page_allocator<int>> test_vector = {1, 2, 3};
+        test_vector.push_back(4);
+        REQUIRE(test_vector.capacity() == 10);
+        REQUIRE(test_vector[3] == 4);
+    }
+
+    SECTION("large blocks are 2 MB aligned")
+    {
+        using Alloc = atl::huge_page_allocator<double, 1 << 16>;
+        atl::vector<double, Alloc> test_vector;
+        test_vector.reserve(100000);
+
+        auto address = reinterpret_cast<std::uintptr_t>(test_vector.data());
+        REQUIRE(address % Alloc::huge_page_size == 0);
+        REQUIRE(test_vector.capacity() == Alloc::huge_page_size / sizeof(double));
+
+        for (int i = 0; i < 300000; i++) {
+            test_vector.push_back(i);
+        }
+        REQUIRE(test_vector[299999] == 299999);
+    }
+}
+
+TEST_CASE("mmap_vector", "[allocator]")
+{
+    SECTION("grows through mremap")
+    {
+        REQUIRE(atl::has_reallocate_v<atl::mmap_allocator<long>>);
+
+        atl::mmap_vector<long> test_vector;
+        test_vector.push_back(0);
+        REQUIRE(test_vector.capacity() * sizeof(long) % 4096 == 0);
+
+        for (long i = 1; i < 1000000; i++) {
+            test_vector.push_back(i);
+        }
+
+        bool all_equal = true;
+        for (long i = 0; i < 1000000; i++) {
+            all_equal = all_equal && test_vector[i] == i;
+        }
+        REQUIRE(all_equal);
+
+        test_vector.resize(10);
+        test_vector.shrink_to_fit();
+        REQUIRE(test_vector.back() == 9);
+    }
+
+    SECTION("non trivially relocatable elements")
+    {
+        atl::mmap_vector<std::string> test_vector;
+        for (int i = 0; i < 2000; i++) {
+            test_vector.push_back(std::to_string(i));
+        }
+        REQUIRE(test_vector[1999] == "1999");
+    }
+}
+
+namespace {
+
+//stateful allocator whose propagation traits are chosen per test
+template <class T, bool Propagate>
+struct tagged_allocator : std::allocator<T>
+{
+    template <class U> struct rebind { using other = tagged_allocator<U, Propagate>; };
+
+    using propagate_on_container_copy_assignment = std::integral_constant<bool, Propagate>;
+    using propagate_on_container_move_assignment = std::integral_constant<bool, Propagate>;
+    using propagate_on_container_swap            = std::integral_constant<bool, Propagate>;
+    using is_always_equal                        = std::false_type;
+
+    explicit tagged_allocator(int tag = 0) : tag(tag) {}
+    template <class U> tagged_allocator(const tagged_allocator<U, Propagate>& other) : tag(other.tag) {}
+
+    friend bool operator==(const tagged_allocator& lhs, const tagged_allocator& rhs) { return lhs.tag == rhs.tag; }
+    friend bool operator!=(const tagged_allocator& lhs, const tagged_allocator& rhs) { return lhs.tag != rhs.tag; }
+
+    int tag;
+};
+
+}
+
+TEST_CASE("allocator propagation", "[allocator]")
+{
+    SECTION("propagating allocator")
+    {
+        using Alloc = tagged_allocator<int, true>;
+        atl::vector<int, Alloc> a({1, 2, 3}, Alloc(1));
+        atl::vector<int, Alloc> b({4, 5}, Alloc(2));
+
+        b = a;
+        REQUIRE(b.get_allocator().tag == 1);
+
+        atl::vector<int, Alloc> c({7}, Alloc(3));
+        c = std::move(a);
+        REQUIRE(c.get_allocator().tag == 1);
+        REQUIRE(c.size() == 3);
+        REQUIRE(a.empty());
+
+        atl::vector<int, Alloc> d({8}, Alloc(4));
+        d.swap(c);
+        REQUIRE(d.get_allocator().tag == 1);
+        REQUIRE(c.get_allocator().tag == 4);
+        REQUIRE(d[2] == 3);
+    }
+
+    SECTION("non propagating allocator")
+    {
+        using Alloc = tagged_allocator<std::string, false>;
+        atl::vector<std::string, Alloc> a({"a", "b"}, Alloc(1));
+        atl::vector<std::string, Alloc> b({"c"}, Alloc(2));
+
+        b = a;
+        REQUIRE(b.get_allocator().tag == 2);
+        REQUIRE(b[1] == "b");
+
+        atl::vector<std::string, Alloc> c({"x"}, Alloc(3));
+        c = std::move(a);
+        REQUIRE(c.get_allocator().tag == 3);
+        REQUIRE(c.size() == 2);
+        REQUIRE(c[0] == "a");
+    }
+
+    SECTION("move constructor keeps the source allocator")
+    {
+        using Alloc = tagged_allocator<int, false>;
+        atl::vector<int, Alloc> a({1, 2}, Alloc(5));
+        atl::vector<int, Alloc> b(std::move(a));
+        REQUIRE(b.get_allocator().tag == 5);
+    }
+
+    SECTION("allocator-extended move with unequal allocators moves elements")
+    {
+        using Alloc = tagged_allocator<std::string, false>;
+        atl::vector<std::string, Alloc> a({"x", "y"}, Alloc(1));
+        auto data = a.data();
+
+        atl::vector<std::string, Alloc> b(std::move(a), Alloc(2));
+        REQUIRE(b.data() != data);
+        REQUIRE(b.get_allocator().tag == 2);
+        REQUIRE(b.size() == 2);
+        REQUIRE(b[0] == "x");
+        REQUIRE(b[1] == "y");
+
+        atl::vector<std::string, Alloc> c(std::move(b), Alloc(2));
+        REQUIRE(c.size() == 2);
+        REQUIRE(b.empty());
+    }
+}
+
+TEST_CASE("pmr vector", "[allocator]")
+{
+    char buffer[4096];
+    std::pmr::monotonic_buffer_resource arena(buffer, sizeof(buffer), std::pmr::null_memory_resource());
+
+    SECTION("allocates from the arena")
+    {
+        atl::pmr::vector<int> test_vector(&arena);
+        for (int i = 0; i < 100; i++) {
+            test_vector.push_back(i);
+        }
+
+        REQUIRE(test_vector.get_allocator().resource() == &arena);
+        auto address = reinterpret_cast<char*>(test_vector.data());
+        REQUIRE(address >= buffer);
+        REQUIRE(address < buffer + sizeof(buffer));
+        REQUIRE(test_vector[99] == 99);
+    }
+
+    SECTION("copies use the default resource, assignment keeps the target's")
+    {
+        atl::pmr::vector<int> test_vector({1, 2, 3}, &arena);
+
+        atl::pmr::vector<int> copy(test_vector);
+        REQUIRE(copy.get_allocator().resource() == std::pmr::get_default_resource());
+
+        atl::pmr::vector<int> assigned(&arena);
+        assigned = copy;
+        REQUIRE(assigned.get_allocator().resource() == &arena);
+        REQUIRE(assigned[2] == 3);
+    }
+
+    SECTION("copies from other allocator and policy specializations")
+    {
+        atl::vector<int> source = {1, 2, 3};
+        atl::pmr::vector<int> on_arena(source, &arena);
+        REQUIRE(on_arena.get_allocator().resource() == &arena);
+        REQUIRE(on_arena.size() == 3);
+        REQUIRE(on_arena[2] == 3);
+
+        atl::vector<int, std::allocator<int>, atl::size_class_growth_policy> back(on_arena);
+        REQUIRE(back.size() == 3);
+        REQUIRE(std::equal(back.begin(), back.end(), source.begin()));
+    }
+
+    SECTION("elements use the container's resource")
+    {
+        atl::pmr::vector<std::pmr::string> test_vector(&arena);
+        test_vector.emplace_back("a string long enough to defeat the small string buffer");
+        REQUIRE(test_vector[0].get_allocator().resource() == &arena);
+    }
+}
@@ -0,0 +1,181 @@
+#include "catch.hpp"
+#include "concurrent_vector.h"
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+#include <numeric>
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+
+namespace {
+
+//copies throw once the shared countdown reaches zero
+struct Bomb
+{
+    static int copies_left;
+
+    Bomb() noexcept = default;
+    explicit Bomb(int v) : value(new int(v)) {}
+    Bomb(const Bomb& other) : value(nullptr)
+    {
+        if (copies_left-- == 0) {
+            throw std::runtime_error("copy failed");
+        }
+        value = new int(*other.value);
+    }
+    ~Bomb() { delete value; }
+
+    int* value = nullptr;
+};
+
+int Bomb::copies_left = 0;
+
+} //namespace
+
+TEST_CASE("concurrent_vector", "[concurrent_vector]")
+{
+    SECTION("single threaded")
+    {
+        atl::concurrent_vector<std::string> test_vector;
+        auto it = test_vector.push_back("a");
+        REQUIRE(it == test_vector.begin());
+        test_vector.emplace_back(3, 'b');
+
+        auto grown = test_vector.grow_by(100, "c");
+        REQUIRE(grown - test_vector.begin() == 2);
+        REQUIRE(test_vector.size() == 102);
+        REQUIRE(test_vector[1] == "bbb");
+        REQUIRE(test_vector.at(101) == "c");
+        REQUIRE_THROWS_AS(test_vector.at(102), std::out_of_range);
+
+        test_vector.grow_by(2);
+        REQUIRE(test_vector[103].empty());
+
+        test_vector.clear();
+        REQUIRE(test_vector.empty());
+    }
+
+    SECTION("concurrent appends")
+    {
+        constexpr int threads = 8;
+        constexpr int per_thread = 20000;
+
+        atl::concurrent_vector<int, std::allocator<int>, 4> test_vector;
+        std::atomic<bool> done{false};
+        std::atomic<bool> bad_read{false};
+        std::thread reader([&] {
+            //unsynchronized with the appenders, so only constructed slots may be read
+            while (!done.load()) {
+                auto size = test_vector.size();
+                for (std::size_t i = size > 64 ? size - 64 : 0; i < size; i++) {
+                    if (test_vector.constructed(i) && test_vector[i] < -1) {
+                        bad_read.store(true);
+                    }
+                }
+            }
+        });
+
+        std::vector<std::thread> workers;
+        for (int t = 0; t < threads; t++) {
+            workers.emplace_back([&test_vector, t] {
+                for (int i = 0; i < per_thread; i++) {
+                    if (i % 100 == 0) {
+                        test_vector.grow_by(2, -1);
+                        test_vector.push_back(t * per_thread + i);
+                    } else {
+                        test_vector.push_back(t * per_thread + i);
+                    }
+                }
+            });
+        }
+        for (auto& worker : workers) {
+            worker.join();
+        }
+        done.store(true);
+        reader.join();
+        REQUIRE(!bad_read.load());
+
+        REQUIRE(test_vector.size() == static_cast<std::size_t>(threads * per_thread + threads * per_thread / 50));
+
+        std::vector<int> values(test_vector.begin(), test_vector.end());
+        values.erase(std::remove(values.begin(), values.end(), -1), values.end());
+        std::sort(values.begin(), values.end());
+        std::vector<int> expected(threads * per_thread);
+        std::iota(expected.begin(), expected.end(), 0);
+        REQUIRE(values == expected);
+    }
+
+    SECTION("addresses are stable and published elements are readable")
+    {
+        atl::concurrent_vector<std::size_t> test_vector;
+        std::atomic<const std::size_t*> last{nullptr};
+        std::atomic<bool> done{false};
+        std::atomic<bool> torn{false};
+
+        std::thread reader([&] {
+            while (!done.load()) {
+                auto element = last.load();
+                if (element != nullptr && *element >= 100000) {
+                    torn.store(true);
+                }
+            }
+        });
+
+        std::vector<const std::size_t*> addresses;
+        for (std::size_t i = 0; i < 100000; i++) {
+            auto it = test_vector.push_back(i);
+            addresses.push_back(&*it);
+            last.store(&*it);
+        }
+        done.store(true);
+        reader.join();
+        REQUIRE(!torn.load());
+
+        for (std::size_t i = 0; i < addresses.size(); i++) {
+            REQUIRE(addresses[i] == &test_vector[i]);
+            REQUIRE(*addresses[i] == i);
+        }
+    }
+
+    SECTION("a throwing copy marks its claimed slots as not constructed")
+    {
+        atl::concurrent_vector<Bomb> test_vector;
+        Bomb proto(7);
+        Bomb::copies_left = 1;
+        test_vector.push_back(proto);
+        REQUIRE(test_vector.constructed(0));
+
+        Bomb::copies_left = 1;
+        REQUIRE_THROWS_AS(test_vector.grow_by(5, proto), std::runtime_error);
+        REQUIRE(test_vector.size() == 6);
+        REQUIRE(test_vector.constructed(1));
+        REQUIRE(*test_vector.at(1).value == 7);
+        for (std::size_t i = 2; i < 6; i++) {
+            REQUIRE_FALSE(test_vector.constructed(i));
+            REQUIRE_THROWS_AS(test_vector.at(i), std::out_of_range);
+        }
+
+        Bomb::copies_left = 0;
+        REQUIRE_THROWS_AS(test_vector.push_back(proto), std::runtime_error);
+        REQUIRE(test_vector.size() == 7);
+        REQUIRE_FALSE(test_vector.constructed(6));
+
+        //clear destroys only the constructed elements and frees the slots for reuse
+        test_vector.clear();
+        Bomb::copies_left = 1;
+        test_vector.push_back(proto);
+        REQUIRE(test_vector.constructed(0));
+        REQUIRE(*test_vector[0].value == 7);
+    }
+
+    SECTION("length_error claims nothing")
+    {
+        atl::concurrent_vector<int> test_vector;
+        test_vector.push_back(1);
+        REQUIRE_THROWS_AS(test_vector.grow_by(std::numeric_limits<std::size_t>::max() - 8), std::length_error);
+        REQUIRE(test_vector.size() == 1);
+        REQUIRE_THROWS_AS(test_vector.reserve(std::numeric_limits<std::size_t>::max()), std::length_error);
+    }
+}
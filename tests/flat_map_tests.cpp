@@ -0,0 +1,145 @@
+#include "catch.hpp"
+#include "flat_map.h"
+#include <map>
+#include <string>
+#include <vector>
+#include <utility>
+#include <stdexcept>
+#include <algorithm>
+
+namespace {
+
+//move construction throws once moves_left runs out
+struct ThrowingMove
+{
+    static int moves_left;
+
+    ThrowingMove(int v) : value(v) {}
+    ThrowingMove(const ThrowingMove&) = default;
+    ThrowingMove(ThrowingMove&& other) : value(other.value)
+    {
+        if (moves_left-- == 0) {
+            throw std::runtime_error("move failed");
+        }
+    }
+    int value;
+};
+
+int ThrowingMove::moves_left = 0;
+
+}
+
+TEST_CASE("flat_map", "[flat_map]")
+{
+    SECTION("bulk construction keeps the first of equal keys")
+    {
+        std::vector<std::pair<int, std::string>> input;
+        for (int i = 0; i < 500; i++) {
+            input.emplace_back(i * 31 % 97, std::to_string(i));
+        }
+
+        atl::flat_map<int, std::string> test_map(input.begin(), input.end());
+        std::map<int, std::string> std_map(input.begin(), input.end());
+
+        REQUIRE(test_map.size() == std_map.size());
+        auto it = test_map.begin();
+        for (const auto& entry : std_map) {
+            REQUIRE((*it).first == entry.first);
+            REQUIRE(it->second == entry.second);
+            ++it;
+        }
+    }
+
+    SECTION("separate key and value containers")
+    {
+        atl::flat_map<std::string, int> test_map(atl::vector<std::string>{"c", "a", "b"}, atl::vector<int>{3, 1, 2});
+        REQUIRE(test_map.keys().size() == 3);
+        REQUIRE(test_map.keys()[0] == "a");
+        REQUIRE(test_map.values()[2] == 3);
+
+        REQUIRE_THROWS_AS((atl::flat_map<std::string, int>(atl::vector<std::string>{"a"}, atl::vector<int>{})), std::invalid_argument);
+    }
+
+    SECTION("element access")
+    {
+        atl::flat_map<std::string, int> test_map;
+        test_map["b"] = 2;
+        test_map["a"] = 1;
+        test_map["b"] += 10;
+
+        REQUIRE(test_map.at("b") == 12);
+        REQUIRE(test_map.at("a") == 1);
+        REQUIRE_THROWS_AS(test_map.at("z"), std::out_of_range);
+
+        REQUIRE(!test_map.try_emplace("a", 5).second);
+        REQUIRE(test_map.insert_or_assign("a", 5).second == false);
+        REQUIRE(test_map.at("a") == 5);
+        REQUIRE(test_map.insert({"c", 3}).second);
+        REQUIRE(test_map.keys().back() == "c");
+    }
+
+    SECTION("batched merge insert and erase")
+    {
+        atl::flat_map<int, int> test_map = {{10, 1}, {20, 2}, {30, 3}};
+        test_map.insert({{25, 9}, {5, 9}, {20, 9}, {40, 9}, {5, 8}});
+
+        REQUIRE(test_map.size() == 6);
+        REQUIRE(std::is_sorted(test_map.keys().begin(), test_map.keys().end()));
+        REQUIRE(test_map.at(20) == 2);
+        REQUIRE(test_map.at(5) == 9);
+
+        REQUIRE(test_map.erase(25) == 1);
+        REQUIRE(test_map.erase(25) == 0);
+        auto it = test_map.erase(test_map.begin());
+        REQUIRE(it->first == 10);
+        REQUIRE(test_map.size() == 4);
+
+        REQUIRE(test_map.lower_bound(11)->first == 20);
+        REQUIRE(test_map.upper_bound(20)->first == 30);
+        REQUIRE(test_map.find(7) == test_map.end());
+        REQUIRE(test_map.contains(40));
+
+        auto range = test_map.equal_range(30);
+        REQUIRE(range.second - range.first == 1);
+        REQUIRE(range.first->second == 3);
+        const auto& const_map = test_map;
+        auto missing = const_map.equal_range(35);
+        REQUIRE(missing.first == missing.second);
+        REQUIRE(missing.first->first == 40);
+    }
+
+    SECTION("a throwing value move keeps keys and values paired")
+    {
+        std::vector<std::pair<int, ThrowingMove>> input = {{1, 10}, {2, 20}, {3, 30}};
+        atl::flat_map<int, ThrowingMove> test_map;
+
+        ThrowingMove::moves_left = 1;
+        REQUIRE_THROWS_AS(test_map.insert(atl::sorted_unique, input.begin(), input.end()), std::runtime_error);
+        REQUIRE(test_map.keys().size() == 1);
+        REQUIRE(test_map.values().size() == 1);
+        REQUIRE(test_map.at(1).value == 10);
+        REQUIRE_FALSE(test_map.contains(2));
+    }
+
+    SECTION("iterators")
+    {
+        atl::flat_map<int, int> test_map = {{3, 30}, {1, 10}, {2, 20}};
+        for (auto entry : test_map) {
+            entry.second += 1;
+        }
+        REQUIRE(test_map.values()[0] == 11);
+
+        const auto& const_map = test_map;
+        std::vector<int> keys;
+        for (auto it = const_map.rbegin(); it != const_map.rend(); ++it) {
+            keys.push_back((*it).first);
+        }
+        REQUIRE(keys == std::vector<int>{3, 2, 1});
+        REQUIRE(const_map.end() - const_map.begin() == 3);
+
+        auto copy = test_map;
+        REQUIRE(copy == test_map);
+        copy[4] = 40;
+        REQUIRE(copy != test_map);
+    }
+}
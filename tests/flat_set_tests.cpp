@@ -0,0 +1,94 @@
+#include "catch.hpp"
+#include "flat_set.h"
+#include <set>
+#include <string>
+#include <vector>
+#include <algorithm>
+
+namespace {
+
+template <class T, class U>
+bool same_elements(const T& a, const U& b)
+{
+    return a.size() == b.size() && std::equal(a.begin(), a.end(), b.begin());
+}
+
+}
+
+TEST_CASE("flat_set", "[flat_set]")
+{
+    SECTION("bulk construction sorts and dedupes")
+    {
+        std::vector<int> input;
+        for (int i = 0; i < 1000; i++) {
+            input.push_back(i * 37 % 101);
+        }
+
+        atl::flat_set<int> test_set(input.begin(), input.end());
+        std::set<int> std_set(input.begin(), input.end());
+        REQUIRE(same_elements(test_set, std_set));
+    }
+
+    SECTION("lookup")
+    {
+        atl::flat_set<int> test_set = {1, 3, 5, 7, 9, 11, 13};
+        for (int key = 0; key < 15; key++) {
+            auto expected = std::lower_bound(test_set.begin(), test_set.end(), key);
+            REQUIRE(test_set.lower_bound(key) == expected);
+            REQUIRE(test_set.upper_bound(key) == std::upper_bound(test_set.begin(), test_set.end(), key));
+            REQUIRE(test_set.contains(key) == (key % 2 == 1 && key < 14));
+        }
+
+        REQUIRE(test_set.find(4) == test_set.end());
+        REQUIRE(*test_set.find(5) == 5);
+        REQUIRE(test_set.count(7) == 1);
+
+        auto range = test_set.equal_range(9);
+        REQUIRE(range.second - range.first == 1);
+
+        atl::flat_set<int> empty_set;
+        REQUIRE(empty_set.lower_bound(1) == empty_set.end());
+        REQUIRE(!empty_set.contains(1));
+    }
+
+    SECTION("single insert and erase")
+    {
+        atl::flat_set<std::string> test_set;
+        REQUIRE(test_set.insert("b").second);
+        REQUIRE(test_set.insert("a").second);
+        REQUIRE(!test_set.insert("b").second);
+        REQUIRE(test_set.emplace(3, 'c').second);
+
+        REQUIRE(same_elements(test_set, std::vector<std::string>{"a", "b", "ccc"}));
+        REQUIRE(test_set.erase("b") == 1);
+        REQUIRE(test_set.erase("b") == 0);
+        REQUIRE(same_elements(test_set, std::vector<std::string>{"a", "ccc"}));
+    }
+
+    SECTION("batched merge insert")
+    {
+        atl::flat_set<int> test_set = {10, 20, 30, 40};
+        test_set.insert({35, 5, 20, 45, 5, 25});
+        REQUIRE(same_elements(test_set, std::vector<int>{5, 10, 20, 25, 30, 35, 40, 45}));
+
+        std::vector<int> tail = {50, 60, 70};
+        test_set.insert(atl::sorted_unique, tail.begin(), tail.end());
+        REQUIRE(test_set.size() == 11);
+        REQUIRE(*test_set.rbegin() == 70);
+    }
+
+    SECTION("custom comparator and extract")
+    {
+        atl::flat_set<int, std::greater<int>> test_set = {1, 4, 2, 4, 3};
+        REQUIRE(same_elements(test_set, std::vector<int>{4, 3, 2, 1}));
+        REQUIRE(test_set.contains(3));
+
+        auto keys = std::move(test_set).extract();
+        REQUIRE(keys.size() == 4);
+
+        atl::flat_set<int, std::greater<int>> other;
+        other.replace(std::move(keys));
+        REQUIRE(other.size() == 4);
+        REQUIRE(*other.lower_bound(5) == 4);
+    }
+}
@@ -0,0 +1,155 @@
+#include "catch.hpp"
+#include "gap_vector.h"
+#include <string>
+#include <vector>
+#include <memory>
+#include <algorithm>
+
+namespace {
+
+template <class T, class U>
+bool same_elements(const T& a, const U& b)
+{
+    return a.size() == b.size() && std::equal(a.begin(), a.end(), b.begin());
+}
+
+}
+
+TEST_CASE("gap_vector", "[gap_vector]")
+{
+    SECTION("clustered inserts at a cursor")
+    {
+        atl::gap_vector<int> test_vector{0, 1, 2, 3, 4, 5};
+        std::vector<int> expected{0, 1, 2, 3, 4, 5};
+
+        auto cursor = test_vector.begin() + 3;
+        auto expected_cursor = expected.begin() + 3;
+        for (int i = 10; i < 40; i++) {
+            cursor = test_vector.insert(cursor, i) + 1;
+            expected_cursor = expected.insert(expected_cursor, i) + 1;
+        }
+
+        REQUIRE(test_vector.gap_position() == 33);
+        REQUIRE(same_elements(test_vector, expected));
+    }
+
+    SECTION("backspace at a cursor")
+    {
+        atl::gap_vector<int> test_vector{0, 1, 2, 3, 4, 5, 6, 7, 8, 9};
+        for (int i = 0; i < 4; i++) {
+            test_vector.erase(test_vector.begin() + 7 - i);
+        }
+
+        REQUIRE(test_vector.gap_position() == 4);
+        REQUIRE(same_elements(test_vector, std::vector<int>{0, 1, 2, 3, 8, 9}));
+    }
+
+    SECTION("range insert and erase")
+    {
+        atl::gap_vector<std::string> test_vector{"a", "b", "c", "d"};
+        std::vector<std::string> words{"x", "y", "z"};
+
+        auto it = test_vector.insert(test_vector.begin() + 1, words.begin(), words.end());
+        REQUIRE(*it == "x");
+        REQUIRE(same_elements(test_vector, std::vector<std::string>{"a", "x", "y", "z", "b", "c", "d"}));
+
+        it = test_vector.erase(test_vector.begin() + 2, test_vector.begin() + 5);
+        REQUIRE(*it == "c");
+        REQUIRE(same_elements(test_vector, std::vector<std::string>{"a", "x", "c", "d"}));
+
+        test_vector.insert(test_vector.end(), 2, "e");
+        test_vector.pop_back();
+        REQUIRE(test_vector.back() == "e");
+        REQUIRE(test_vector.size() == 5);
+    }
+
+    SECTION("inserting an own element")
+    {
+        atl::gap_vector<std::string> test_vector{"first", "second"};
+        for (int i = 0; i < 20; i++) {
+            test_vector.insert(test_vector.begin(), test_vector.back());
+        }
+
+        REQUIRE(test_vector.size() == 22);
+        REQUIRE(std::count(test_vector.begin(), test_vector.end(), "second") == 21);
+    }
+
+    SECTION("emplacing and moving an own element")
+    {
+        const std::string long_a(40, 'a');
+        const std::string long_b(40, 'b');
+
+        atl::gap_vector<std::string> test_vector{long_a};
+        while (test_vector.size() < test_vector.capacity()) {
+            test_vector.push_back(long_b);
+        }
+        auto full = test_vector.size();
+
+        //the buffer is full, so the argument would be relocated by growing the gap
+        test_vector.emplace_back(test_vector[0]);
+        REQUIRE(test_vector.size() == full + 1);
+        REQUIRE(test_vector.back() == long_a);
+
+        test_vector.emplace(test_vector.begin() + 1, test_vector.back(), 0, 10);
+        REQUIRE(test_vector[1] == long_a.substr(0, 10));
+
+        test_vector.insert(test_vector.begin(), std::move(test_vector[3]));
+        REQUIRE(test_vector[0] == long_b);
+        REQUIRE(test_vector.size() == full + 3);
+    }
+
+    SECTION("linearize")
+    {
+        atl::gap_vector<int> test_vector{0, 1, 2, 3, 4};
+        test_vector.insert(test_vector.begin() + 2, 9);
+
+        auto data = test_vector.linearize();
+        REQUIRE(test_vector.gap_position() == test_vector.size());
+        REQUIRE(std::vector<int>(data, data + test_vector.size()) == std::vector<int>{0, 1, 9, 2, 3, 4});
+        REQUIRE(test_vector.data() == data);
+    }
+
+    SECTION("move-only elements")
+    {
+        atl::gap_vector<std::unique_ptr<int>> test_vector;
+        for (int i = 0; i < 16; i++) {
+            test_vector.emplace(test_vector.begin() + test_vector.size() / 2, new int(i));
+        }
+        test_vector.erase(test_vector.begin() + 3);
+
+        auto moved = std::move(test_vector);
+        REQUIRE(test_vector.empty());
+        REQUIRE(moved.size() == 15);
+        REQUIRE(*moved.front() == 1);
+    }
+
+    SECTION("iterators work with standard algorithms")
+    {
+        atl::gap_vector<int> test_vector{5, 3, 1, 4, 2};
+        test_vector.insert(test_vector.begin() + 2, 0);
+
+        std::sort(test_vector.begin(), test_vector.end());
+        REQUIRE(same_elements(test_vector, std::vector<int>{0, 1, 2, 3, 4, 5}));
+        REQUIRE(std::lower_bound(test_vector.cbegin(), test_vector.cend(), 3) - test_vector.cbegin() == 3);
+        REQUIRE(std::vector<int>(test_vector.rbegin(), test_vector.rend()) == std::vector<int>{5, 4, 3, 2, 1, 0});
+    }
+
+    SECTION("copy, assignment and swap")
+    {
+        atl::gap_vector<std::string> test_vector{"a", "b", "c"};
+        test_vector.erase(test_vector.begin());
+
+        atl::gap_vector<std::string> copy(test_vector);
+        REQUIRE(copy == test_vector);
+
+        atl::gap_vector<std::string> other{"z"};
+        other = copy;
+        REQUIRE(other == test_vector);
+
+        other.push_back("d");
+        swap(other, test_vector);
+        REQUIRE(test_vector.size() == 3);
+        REQUIRE(other.size() == 2);
+        REQUIRE_THROWS_AS(other.at(2), std::out_of_range);
+    }
+}
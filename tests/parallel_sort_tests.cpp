@@ -0,0 +1,119 @@
+#include "catch.hpp"
+#include "parallel_sort.h"
+#include <memory>
+#include <random>
+#include <string>
+#include <utility>
+#include <stdexcept>
+#include <algorithm>
+#include <functional>
+
+TEST_CASE("parallel_sort", "[parallel]")
+{
+    atl::parallel::thread_pool pool(4);
+
+    std::mt19937 random(42);
+    atl::vector<int> values(100003);
+    for (auto& v : values) {
+        v = static_cast<int>(random() % 1000);
+    }
+
+    SECTION("matches std::sort")
+    {
+        std::vector<int> expected(values.begin(), values.end());
+        std::sort(expected.begin(), expected.end());
+
+        atl::parallel_sort(pool, values);
+        REQUIRE(std::equal(values.begin(), values.end(), expected.begin(), expected.end()));
+
+        atl::parallel_sort(pool, values, std::greater<int>());
+        REQUIRE(std::is_sorted(values.begin(), values.end(), std::greater<int>()));
+    }
+
+    SECTION("small and single-threaded inputs")
+    {
+        atl::vector<int> empty;
+        atl::parallel_sort(pool, empty);
+        atl::parallel_stable_sort(pool, empty);
+        REQUIRE(empty.empty());
+
+        atl::vector<int> few = {5, 3, 9, 1};
+        atl::parallel_stable_sort(pool, few);
+        REQUIRE(few == atl::vector<int>({1, 3, 5, 9}));
+
+        atl::parallel::thread_pool serial(1);
+        atl::parallel_stable_sort(serial, values);
+        REQUIRE(std::is_sorted(values.begin(), values.end()));
+    }
+
+    SECTION("stable sort keeps equal keys in order")
+    {
+        atl::vector<std::pair<int, int>> pairs(values.size());
+        for (std::size_t i = 0; i < values.size(); i++) {
+            pairs[i] = {values[i], static_cast<int>(i)};
+        }
+        auto by_key = [](const std::pair<int, int>& lhs, const std::pair<int, int>& rhs) { return lhs.first < rhs.first; };
+
+        atl::parallel_stable_sort(pool, pairs, by_key);
+        REQUIRE(std::is_sorted(pairs.begin(), pairs.end()));
+    }
+
+    SECTION("scratch buffer is reused")
+    {
+        atl::vector<int> scratch;
+        scratch.reserve(values.size());
+        auto buffer = scratch.data();
+
+        atl::parallel_sort(pool, values, scratch);
+        REQUIRE(std::is_sorted(values.begin(), values.end()));
+        REQUIRE(scratch.data() == buffer);
+
+        std::shuffle(values.begin(), values.end(), random);
+        atl::parallel_stable_sort(pool, values, scratch);
+        REQUIRE(std::is_sorted(values.begin(), values.end()));
+        REQUIRE(scratch.data() == buffer);
+    }
+
+    SECTION("move-only elements")
+    {
+        atl::vector<std::unique_ptr<int>> pointers(50000);
+        for (auto& p : pointers) {
+            p = std::make_unique<int>(static_cast<int>(random() % 1000));
+        }
+        auto by_value = [](const std::unique_ptr<int>& lhs, const std::unique_ptr<int>& rhs) { return *lhs < *rhs; };
+
+        atl::parallel_sort(pool, pointers, by_value);
+        REQUIRE(std::is_sorted(pointers.begin(), pointers.end(), by_value));
+
+        std::shuffle(pointers.begin(), pointers.end(), random);
+        atl::parallel_stable_sort(pool, pointers, by_value);
+        REQUIRE(std::is_sorted(pointers.begin(), pointers.end(), by_value));
+        REQUIRE(std::all_of(pointers.begin(), pointers.end(), [](const std::unique_ptr<int>& p) { return p != nullptr; }));
+    }
+
+    SECTION("allocating elements")
+    {
+        atl::vector<std::string> strings(50000);
+        for (auto& s : strings) {
+            s = std::to_string(random());
+        }
+        std::vector<std::string> expected(strings.begin(), strings.end());
+        std::stable_sort(expected.begin(), expected.end());
+
+        atl::parallel_stable_sort(pool, strings);
+        REQUIRE(std::equal(strings.begin(), strings.end(), expected.begin(), expected.end()));
+    }
+
+    SECTION("comparator exceptions propagate")
+    {
+        int calls = 0;
+        auto throwing = [&calls](int lhs, int rhs) {
+            if (++calls == 50000) {
+                throw std::runtime_error("comparison failed");
+            }
+            return lhs < rhs;
+        };
+        atl::parallel::thread_pool serial(1);
+        REQUIRE_THROWS_AS(atl::parallel_stable_sort(serial, values, throwing), std::runtime_error);
+    }
+}
@@ -0,0 +1,85 @@
+#include "catch.hpp"
+#include "parallel.h"
+#include <atomic>
+#include <string>
+#include <numeric>
+#include <stdexcept>
+
+TEST_CASE("parallel", "[parallel]")
+{
+    atl::parallel::thread_pool pool(4);
+
+    atl::vector<int> values(100000);
+    std::iota(values.begin(), values.end(), 0);
+
+    SECTION("for_range covers every index once")
+    {
+        atl::vector<int> hits(12345);
+        std::atomic<bool> oversized{false};
+        pool.for_range(hits.size(), 100, [&](std::size_t begin, std::size_t end) {
+            if (end - begin > 100) {
+                oversized.store(true);
+            }
+            for (auto i = begin; i != end; i++) {
+                hits[i]++;
+            }
+        });
+        REQUIRE(!oversized.load());
+        REQUIRE(std::all_of(hits.begin(), hits.end(), [](int h) { return h == 1; }));
+    }
+
+    SECTION("for_each and transform")
+    {
+        atl::parallel::for_each(pool, values, [](int& v) { v *= 2; });
+        REQUIRE(values[99999] == 199998);
+
+        atl::vector<std::string> strings;
+        atl::parallel::transform(pool, values, strings, [](int v) { return std::to_string(v); });
+        REQUIRE(strings.size() == values.size());
+        REQUIRE(strings[12345] == "24690");
+
+        atl::parallel::transform(values, values, [](int v) { return v / 2; });
+        REQUIRE(values[777] == 777);
+    }
+
+    SECTION("reductions")
+    {
+        REQUIRE(atl::parallel::reduce(pool, values, 0LL, [](long long a, long long b) { return a + b; }) == 4999950000LL);
+        REQUIRE(atl::parallel::transform_reduce(pool, values, 0.0, [](double a, double b) { return a + b; },
+                                                [](int v) { return v * 0.5; }) == 2499975000.0);
+        REQUIRE(atl::parallel::count_if(pool, values, [](int v) { return v % 3 == 0; }) == 33334);
+        REQUIRE(atl::parallel::count_if(values, [](int v) { return v < 0; }) == 0);
+
+        //chunks are combined in order, so a non-commutative op gives the serial result
+        atl::vector<std::string> letters(30000, "a");
+        letters[0] = "b";
+        letters[29999] = "c";
+        auto joined = atl::parallel::reduce(pool, letters, std::string(), [](std::string a, const std::string& b) { return a += b; });
+        REQUIRE(joined.size() == 30000);
+        REQUIRE(joined.front() == 'b');
+        REQUIRE(joined.back() == 'c');
+
+        atl::vector<int> empty;
+        REQUIRE(atl::parallel::reduce(pool, empty, 7, [](int a, int b) { return a + b; }) == 7);
+    }
+
+    SECTION("exceptions reach the caller")
+    {
+        REQUIRE_THROWS_AS(atl::parallel::for_each(pool, values, [](int& v) {
+            if (v == 50000) {
+                throw std::runtime_error("bad element");
+            }
+        }), std::runtime_error);
+    }
+
+    SECTION("nested parallelism")
+    {
+        atl::vector<long long> sums(8);
+        pool.for_range(sums.size(), 1, [&](std::size_t begin, std::size_t end) {
+            for (auto i = begin; i != end; i++) {
+                sums[i] = atl::parallel::reduce(pool, values, 0LL, [](long long a, long long b) { return a + b; });
+            }
+        });
+        REQUIRE(std::all_of(sums.begin(), sums.end(), [](long long s) { return s == 4999950000LL; }));
+    }
+}
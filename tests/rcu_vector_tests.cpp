@@ -0,0 +1,98 @@
+#include "catch.hpp"
+#include "rcu_vector.h"
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+#include <numeric>
+#include <algorithm>
+
+TEST_CASE("rcu_vector", "[rcu_vector]")
+{
+    SECTION("snapshots outlive newer versions")
+    {
+        atl::rcu_vector<std::string> table(atl::vector<std::string>{"a", "b"});
+        auto reader = table.make_reader();
+
+        {
+            auto before = reader.read();
+            table.publish(atl::vector<std::string>{"c"});
+            table.update([](atl::vector<std::string>& next) { next.push_back("d"); });
+
+            REQUIRE(before.size() == 2);
+            REQUIRE(before[1] == "b");
+            REQUIRE(table.retired() == 2);
+            REQUIRE(table.reclaim() == 2);
+        }
+
+        REQUIRE(table.reclaim() == 0);
+
+        auto after = reader.read();
+        REQUIRE(after.size() == 2);
+        REQUIRE(after[0] == "c");
+        REQUIRE(after[1] == "d");
+    }
+
+    SECTION("later snapshots do not hold back reclamation")
+    {
+        atl::rcu_vector<int> table;
+        auto reader = table.make_reader();
+
+        table.publish(atl::vector<int>{1});
+        auto snapshot = reader.read();
+        table.publish(atl::vector<int>{2});
+
+        //the snapshot started after the first publish, so only the version it sees is pinned
+        REQUIRE(table.retired() == 1);
+        REQUIRE(snapshot[0] == 1);
+    }
+
+    SECTION("reader slots are limited and reusable")
+    {
+        atl::rcu_vector<int, std::allocator<int>, 2> table;
+        auto first = table.make_reader();
+        {
+            auto second = table.make_reader();
+            REQUIRE_THROWS_AS(table.make_reader(), std::length_error);
+        }
+        auto third = table.make_reader();
+        REQUIRE(third.read().empty());
+    }
+
+    SECTION("concurrent readers and writer")
+    {
+        constexpr int readers = 4;
+        constexpr int versions = 2000;
+
+        atl::rcu_vector<int> table(atl::vector<int>(16, 0));
+        std::atomic<bool> done{false};
+        std::atomic<bool> inconsistent{false};
+
+        std::vector<std::thread> threads;
+        for (int r = 0; r < readers; r++) {
+            threads.emplace_back([&] {
+                auto reader = table.make_reader();
+                while (!done.load()) {
+                    auto snapshot = reader.read();
+                    //every version holds 16 copies of its number
+                    if (snapshot.size() != 16 || std::count(snapshot.begin(), snapshot.end(), snapshot[0]) != 16) {
+                        inconsistent.store(true);
+                    }
+                }
+            });
+        }
+
+        for (int v = 1; v <= versions; v++) {
+            table.publish(atl::vector<int>(16, v));
+        }
+        done.store(true);
+        for (auto& thread : threads) {
+            thread.join();
+        }
+        table.synchronize();
+
+        REQUIRE(!inconsistent.load());
+        REQUIRE(table.retired() == 0);
+        REQUIRE(table.make_reader().read()[15] == versions);
+    }
+}
@@ -0,0 +1,120 @@
+#include "catch.hpp"
+#include "segmented_vector.h"
+#include <string>
+#include <vector>
+#include <memory>
+#include <iterator>
+#include <algorithm>
+#include <type_traits>
+
+namespace {
+
+template <class T, class U>
+bool same_elements(const T& a, const U& b)
+{
+    return a.size() == b.size() && std::equal(a.begin(), a.end(), b.begin());
+}
+
+}
+
+TEST_CASE("segmented_vector", "[segmented_vector]")
+{
+    SECTION("indexing across segments")
+    {
+        atl::segmented_vector<int, std::allocator<int>, 4> test_vector;
+        for (int i = 0; i < 1000; i++) {
+            test_vector.push_back(i);
+        }
+
+        REQUIRE(test_vector.size() == 1000);
+        REQUIRE(test_vector.capacity() == 1020);
+        REQUIRE(test_vector.segment_count() == 8);
+        for (int i = 0; i < 1000; i++) {
+            REQUIRE(test_vector[i] == i);
+        }
+        REQUIRE(test_vector.front() == 0);
+        REQUIRE(test_vector.back() == 999);
+        REQUIRE_THROWS_AS(test_vector.at(1000), std::out_of_range);
+    }
+
+    SECTION("references stay valid while growing")
+    {
+        atl::segmented_vector<std::string> test_vector;
+        std::vector<const std::string*> addresses;
+        for (int i = 0; i < 5000; i++) {
+            addresses.push_back(&test_vector.emplace_back(std::to_string(i)));
+        }
+
+        for (int i = 0; i < 5000; i++) {
+            REQUIRE(addresses[i] == &test_vector[i]);
+            REQUIRE(*addresses[i] == std::to_string(i));
+        }
+    }
+
+    SECTION("random access iterators")
+    {
+        atl::segmented_vector<int> test_vector;
+        for (int i = 0; i < 300; i++) {
+            test_vector.push_back((i * 7919) % 300);
+        }
+
+        std::sort(test_vector.begin(), test_vector.end());
+        REQUIRE(std::is_sorted(test_vector.cbegin(), test_vector.cend()));
+        REQUIRE(test_vector.end() - test_vector.begin() == 300);
+        REQUIRE(*(test_vector.rbegin() + 1) == 298);
+        REQUIRE(std::lower_bound(test_vector.begin(), test_vector.end(), 150) - test_vector.begin() == 150);
+
+        using const_traits = std::iterator_traits<atl::segmented_vector<int>::const_iterator>;
+        static_assert(std::is_same<const_traits::value_type, int>::value, "value_type is never const");
+        static_assert(std::is_same<const_traits::reference, const int&>::value, "");
+        static_assert(std::is_same<const_traits::pointer, const int*>::value, "");
+        const_traits::value_type copy = *test_vector.cbegin();
+        copy = *(test_vector.cend() - 1);
+        REQUIRE(copy == 299);
+    }
+
+    SECTION("resize, pop_back and shrink_to_fit")
+    {
+        atl::segmented_vector<std::string, std::allocator<std::string>, 8> test_vector(100, "x");
+        REQUIRE(test_vector.segment_count() == 4);
+
+        test_vector.resize(10);
+        test_vector.pop_back();
+        REQUIRE(test_vector.size() == 9);
+        test_vector.shrink_to_fit();
+        REQUIRE(test_vector.segment_count() == 2);
+        REQUIRE(test_vector.capacity() == 24);
+
+        test_vector.resize(12);
+        REQUIRE(test_vector.back().empty());
+        test_vector.clear();
+        test_vector.shrink_to_fit();
+        REQUIRE(test_vector.capacity() == 0);
+    }
+
+    SECTION("copy, move and swap")
+    {
+        atl::segmented_vector<std::unique_ptr<int>> owners;
+        for (int i = 0; i < 40; i++) {
+            owners.emplace_back(new int(i));
+        }
+        auto first = owners[0].get();
+
+        auto moved = std::move(owners);
+        REQUIRE(owners.empty());
+        REQUIRE(moved[0].get() == first);
+
+        atl::segmented_vector<int> test_vector = {1, 2, 3};
+        atl::segmented_vector<int> copy(test_vector);
+        REQUIRE(copy == test_vector);
+
+        atl::segmented_vector<int> other = {4};
+        other = test_vector;
+        REQUIRE(same_elements(other, std::vector<int>{1, 2, 3}));
+
+        other.push_back(4);
+        swap(other, test_vector);
+        REQUIRE(test_vector.size() == 4);
+        REQUIRE(other != test_vector);
+    }
+}
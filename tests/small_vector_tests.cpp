@@ -0,0 +1,175 @@
+#include "catch.hpp"
+#include "small_vector.h"
+#include <string>
+#include <vector>
+#include <type_traits>
+#include <memory_resource>
+
+namespace {
+
+//counts upstream allocations to check that inline storage really avoids the heap
+template <class T>
+struct counting_allocator : std::allocator<T>
+{
+    template <class U> struct rebind { using other = counting_allocator<U>; };
+
+    counting_allocator() = default;
+    template <class U> counting_allocator(const counting_allocator<U>&) {}
+
+    T* allocate(std::size_t n)
+    {
+        ++allocations;
+        return std::allocator<T>::allocate(n);
+    }
+
+    static inline int allocations = 0;
+};
+
+template <class T, class U>
+bool same_elements(const T& a, const U& b)
+{
+    return a.size() == b.size() && std::equal(a.begin(), a.end(), b.begin());
+}
+
+}
+
+TEST_CASE("small_vector storage", "[small_vector]")
+{
+    SECTION("stays inline up to N")
+    {
+        using Alloc = counting_allocator<int>;
+        Alloc::allocations = 0;
+
+        atl::small_vector<int, 8, Alloc> test_vector;
+        REQUIRE(test_vector.is_inline());
+        REQUIRE(test_vector.capacity() == 8);
+
+        for (int i = 0; i < 8; i++) {
+            test_vector.push_back(i);
+        }
+        REQUIRE(test_vector.is_inline());
+        REQUIRE(Alloc::allocations == 0);
+
+        test_vector.push_back(8);
+        REQUIRE_FALSE(test_vector.is_inline());
+        REQUIRE(Alloc::allocations == 1);
+
+        for (int i = 0; i < 9; i++) {
+            REQUIRE(test_vector[i] == i);
+        }
+    }
+
+    SECTION("shrink_to_fit returns to the inline buffer")
+    {
+        atl::small_vector<std::string, 4> test_vector = {"a", "b", "c", "d", "e"};
+        REQUIRE_FALSE(test_vector.is_inline());
+
+        test_vector.pop_back();
+        test_vector.pop_back();
+        test_vector.shrink_to_fit();
+        REQUIRE(test_vector.is_inline());
+        REQUIRE(test_vector.capacity() == 4);
+        REQUIRE(same_elements(test_vector, std::vector<std::string>{"a", "b", "c"}));
+    }
+
+    SECTION("shrink_to_fit keeps inline elements inline")
+    {
+        atl::small_vector<int, 8> test_vector = {1, 2, 3};
+        test_vector.shrink_to_fit();
+        REQUIRE(test_vector.is_inline());
+        REQUIRE(test_vector.capacity() == 8);
+        REQUIRE(same_elements(test_vector, std::vector<int>{1, 2, 3}));
+
+        atl::small_vector<int, 8> empty;
+        empty.shrink_to_fit();
+        REQUIRE(empty.is_inline());
+        REQUIRE(empty.capacity() == 8);
+
+        atl::small_vector<int, 2> heap = {1, 2, 3, 4, 5};
+        heap.reserve(100);
+        heap.shrink_to_fit();
+        REQUIRE_FALSE(heap.is_inline());
+        REQUIRE(heap.capacity() == 5);
+    }
+
+    SECTION("shared modifiers")
+    {
+        atl::small_vector<std::string, 4> test_vector = {"a", "d"};
+        test_vector.insert(test_vector.begin() + 1, {"b", "c"});
+        test_vector.emplace(test_vector.end(), "e");
+        test_vector.erase(test_vector.begin());
+
+        REQUIRE(same_elements(test_vector, std::vector<std::string>{"b", "c", "d", "e"}));
+    }
+}
+
+TEST_CASE("small_vector copy and move", "[small_vector]")
+{
+    SECTION("copy")
+    {
+        atl::small_vector<std::string, 2> inline_vector = {"a"};
+        atl::small_vector<std::string, 2> heap_vector = {"a", "b", "c"};
+
+        auto inline_copy = inline_vector;
+        auto heap_copy = heap_vector;
+        REQUIRE(inline_copy.is_inline());
+        REQUIRE(same_elements(inline_copy, inline_vector));
+        REQUIRE(same_elements(heap_copy, heap_vector));
+
+        heap_copy = inline_vector;
+        REQUIRE(same_elements(heap_copy, inline_vector));
+    }
+
+    SECTION("move inline")
+    {
+        atl::small_vector<std::string, 4> source = {"a", "b"};
+        atl::small_vector<std::string, 4> target(std::move(source));
+
+        REQUIRE(target.is_inline());
+        REQUIRE(source.empty());
+        REQUIRE(same_elements(target, std::vector<std::string>{"a", "b"}));
+    }
+
+    SECTION("move steals the heap buffer")
+    {
+        atl::small_vector<int, 2> source = {1, 2, 3, 4};
+        auto data = source.data();
+
+        atl::small_vector<int, 2> target(std::move(source));
+        REQUIRE(target.data() == data);
+        REQUIRE(source.empty());
+        REQUIRE(source.is_inline());
+
+        atl::small_vector<int, 2> assigned = {7};
+        assigned = std::move(target);
+        REQUIRE(assigned.data() == data);
+        REQUIRE(same_elements(assigned, std::vector<int>{1, 2, 3, 4}));
+
+        //unequal allocators fall back to an element-wise move that may allocate
+        static_assert(std::is_nothrow_move_assignable<atl::small_vector<int, 2>>::value, "");
+        static_assert(!std::is_nothrow_move_assignable<atl::small_vector<int, 2, std::pmr::polymorphic_allocator<int>>>::value, "");
+    }
+
+    SECTION("swap")
+    {
+        atl::small_vector<std::string, 3> a = {"a"};
+        atl::small_vector<std::string, 3> b = {"x", "y"};
+        atl::small_vector<std::string, 3> c = {"1", "2", "3", "4"};
+        atl::small_vector<std::string, 3> d = {"5", "6", "7", "8", "9"};
+
+        a.swap(b);
+        REQUIRE(same_elements(a, std::vector<std::string>{"x", "y"}));
+        REQUIRE(same_elements(b, std::vector<std::string>{"a"}));
+
+        auto heap_data = c.data();
+        a.swap(c);
+        REQUIRE(a.data() == heap_data);
+        REQUIRE(c.is_inline());
+        REQUIRE(same_elements(a, std::vector<std::string>{"1", "2", "3", "4"}));
+        REQUIRE(same_elements(c, std::vector<std::string>{"x", "y"}));
+
+        swap(a, d);
+        REQUIRE(same_elements(a, std::vector<std::string>{"5", "6", "7", "8", "9"}));
+        REQUIRE(same_elements(d, std::vector<std::string>{"1", "2", "3", "4"}));
+    }
+}
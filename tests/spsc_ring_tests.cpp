@@ -0,0 +1,129 @@
+#include "catch.hpp"
+#include "spsc_ring.h"
+#include <string>
+#include <thread>
+#include <vector>
+#include <limits>
+#include <stdexcept>
+#include <numeric>
+#include <algorithm>
+
+namespace {
+
+std::size_t allocations = 0;
+
+template <class T>
+struct counting_allocator : std::allocator<T>
+{
+    template <class U> struct rebind { using other = counting_allocator<U>; };
+
+    counting_allocator() = default;
+    template <class U> counting_allocator(const counting_allocator<U>&) {}
+
+    T* allocate(std::size_t n)
+    {
+        allocations++;
+        return std::allocator<T>::allocate(n);
+    }
+};
+
+}
+
+TEST_CASE("spsc_ring", "[spsc_ring]")
+{
+    SECTION("capacity rounds up to a power of two")
+    {
+        REQUIRE(atl::spsc_ring<int>(5).capacity() == 8);
+        REQUIRE(atl::spsc_ring<int>(16).capacity() == 16);
+        REQUIRE(atl::spsc_ring<int>(0).capacity() == 1);
+
+        constexpr auto top = std::size_t(1) << (std::numeric_limits<std::size_t>::digits - 1);
+        REQUIRE(atl::detail::round_up_to_power_of_two(top) == top);
+        REQUIRE_THROWS_AS(atl::spsc_ring<int>(top + 1), std::length_error);
+        REQUIRE_THROWS_AS(atl::spsc_ring<int>(std::numeric_limits<std::size_t>::max()), std::length_error);
+    }
+
+    SECTION("single element push and pop")
+    {
+        atl::spsc_ring<std::string> ring(2);
+        REQUIRE(ring.try_push("a"));
+        REQUIRE(ring.try_push(std::string("b")));
+        REQUIRE(!ring.try_push("c"));
+        REQUIRE(ring.size() == 2);
+
+        std::string out;
+        REQUIRE(ring.try_pop(out));
+        REQUIRE(out == "a");
+        REQUIRE(ring.try_push("c"));
+        REQUIRE(ring.try_pop(out));
+        REQUIRE(out == "b");
+        REQUIRE(ring.try_pop(out));
+        REQUIRE(out == "c");
+        REQUIRE(!ring.try_pop(out));
+        REQUIRE(ring.empty());
+    }
+
+    SECTION("batches wrap around the end")
+    {
+        atl::spsc_ring<int> ring(8);
+        std::vector<int> input(20);
+        std::iota(input.begin(), input.end(), 0);
+        std::vector<int> output(20, -1);
+
+        REQUIRE(ring.push_n(input.begin(), 6) == 6);
+        REQUIRE(ring.pop_n(output.begin(), 4) == 4);
+        REQUIRE(ring.push_n(input.begin() + 6, 10) == 6);
+        REQUIRE(ring.size() == 8);
+        REQUIRE(ring.pop_n(output.begin() + 4, 20) == 8);
+        REQUIRE(std::equal(output.begin(), output.begin() + 12, input.begin()));
+        REQUIRE(ring.pop_n(output.begin(), 1) == 0);
+    }
+
+    SECTION("no allocations after construction")
+    {
+        atl::spsc_ring<int, counting_allocator<int>> ring(64);
+        auto before = allocations;
+
+        int values[16] = {};
+        int out[16];
+        for (int i = 0; i < 1000; i++) {
+            ring.push_n(values, 16);
+            ring.try_push(i);
+            ring.try_pop(out[0]);
+            ring.pop_n(out, 16);
+        }
+        REQUIRE(allocations == before);
+    }
+
+    SECTION("producer and consumer threads")
+    {
+        constexpr std::size_t count = 200000;
+        atl::spsc_ring<std::size_t> ring(256);
+
+        std::thread producer([&ring] {
+            std::size_t batch[7];
+            for (std::size_t next = 0; next < count;) {
+                auto n = std::min<std::size_t>(7, count - next);
+                std::iota(batch, batch + n, next);
+                next += ring.push_n(batch, n);
+            }
+        });
+
+        std::vector<std::size_t> received;
+        received.reserve(count);
+        std::size_t batch[5];
+        while (received.size() < count) {
+            auto n = ring.pop_n(batch, 5);
+            received.insert(received.end(), batch, batch + n);
+            std::size_t single;
+            if (ring.try_pop(single)) {
+                received.push_back(single);
+            }
+        }
+        producer.join();
+
+        std::vector<std::size_t> expected(count);
+        std::iota(expected.begin(), expected.end(), 0);
+        REQUIRE(received == expected);
+    }
+}
@@ -0,0 +1,91 @@
+#include "catch.hpp"
+#include "static_vector.h"
+#include <string>
+#include <vector>
+#include <algorithm>
+
+namespace {
+
+template <class T, class U>
+bool same_elements(const T& a, const U& b)
+{
+    return a.size() == b.size() && std::equal(a.begin(), a.end(), b.begin());
+}
+
+}
+
+TEST_CASE("static_vector", "[static_vector]")
+{
+    SECTION("size type")
+    {
+        REQUIRE(std::is_same<atl::static_vector<int, 16>::size_type, std::uint8_t>::value);
+        REQUIRE(std::is_same<atl::static_vector<char, 1000>::size_type, std::uint16_t>::value);
+        REQUIRE(sizeof(atl::static_vector<char, 7>) == 8);
+    }
+
+    SECTION("push_back and failure on full")
+    {
+        atl::static_vector<int, 4> test_vector;
+        for (int i = 0; i < 4; i++) {
+            REQUIRE(test_vector.try_push_back(i) != nullptr);
+        }
+
+        REQUIRE(test_vector.full());
+        REQUIRE(test_vector.try_push_back(4) == nullptr);
+        REQUIRE_THROWS_AS(test_vector.push_back(4), std::length_error);
+        REQUIRE_THROWS_AS(test_vector.resize(300), std::length_error);
+        REQUIRE_THROWS_AS(test_vector.at(4), std::out_of_range);
+        REQUIRE(same_elements(test_vector, std::vector<int>{0, 1, 2, 3}));
+    }
+
+    SECTION("insert and erase")
+    {
+        atl::static_vector<std::string, 10> test_vector = {"a", "e"};
+        std::vector<std::string> std_vector = {"a", "e"};
+
+        test_vector.insert(test_vector.begin() + 1, {"b", "c", "d"});
+        std_vector.insert(std_vector.begin() + 1, {"b", "c", "d"});
+        REQUIRE(same_elements(test_vector, std_vector));
+
+        test_vector.insert(test_vector.begin(), 2, "z");
+        std_vector.insert(std_vector.begin(), 2, "z");
+        REQUIRE(same_elements(test_vector, std_vector));
+
+        test_vector.emplace(test_vector.end() - 1, 3, 'q');
+        std_vector.emplace(std_vector.end() - 1, 3, 'q');
+        REQUIRE(same_elements(test_vector, std_vector));
+
+        test_vector.erase(test_vector.begin() + 1, test_vector.begin() + 4);
+        std_vector.erase(std_vector.begin() + 1, std_vector.begin() + 4);
+        REQUIRE(same_elements(test_vector, std_vector));
+
+        test_vector.erase(test_vector.begin());
+        std_vector.erase(std_vector.begin());
+        REQUIRE(same_elements(test_vector, std_vector));
+    }
+
+    SECTION("copy, move, assign and swap")
+    {
+        atl::static_vector<std::string, 5> a = {"x", "y", "z"};
+        atl::static_vector<std::string, 5> b = a;
+        REQUIRE(a == b);
+
+        atl::static_vector<std::string, 5> c(std::move(b));
+        REQUIRE(c == a);
+
+        c.assign(2, "k");
+        REQUIRE(same_elements(c, std::vector<std::string>{"k", "k"}));
+
+        swap(a, c);
+        REQUIRE(same_elements(a, std::vector<std::string>{"k", "k"}));
+        REQUIRE(same_elements(c, std::vector<std::string>{"x", "y", "z"}));
+        REQUIRE(a < c);
+    }
+
+    SECTION("works with standard algorithms")
+    {
+        atl::static_vector<int, 8> test_vector = {5, 3, 7, 1};
+        std::sort(test_vector.begin(), test_vector.end());
+        REQUIRE(same_elements(test_vector, std::vector<int>{1, 3, 5, 7}));
+    }
+}
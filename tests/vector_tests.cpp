@@ -2,6 +2,10 @@
 #include "vector.h"
 #include <memory>
 #include <cstring>
+#include <cstdint>
+#include <cmath>
+#include <string>
+#include <stdexcept>
 
 template <class T, class U, class = typename T::iterator, class = typename U::iterator>
 bool is_same(const T& a, const U& s)
@@ -58,6 +62,60 @@ public:
     int* large_field_b;
 };
 
+struct UniqueHolder
+{
+    UniqueHolder() = default;
+    explicit UniqueHolder(int v) : value(new int(v)) {}
+    std::unique_ptr<int> value;
+};
+
+struct Fingerprint
+{
+    std::uint32_t high;
+    std::uint32_t low;
+    friend bool operator==(const Fingerprint& lhs, const Fingerprint& rhs) { return lhs.high == rhs.high && lhs.low == rhs.low; }
+    friend bool operator!=(const Fingerprint& lhs, const Fingerprint& rhs) { return !(lhs == rhs); }
+};
+
+//copy construction throws once copies_left runs out
+struct ThrowingCopy
+{
+    static int copies_left;
+
+    ThrowingCopy(const char* v) : value(v) {}
+    ThrowingCopy(ThrowingCopy&&) noexcept = default;
+    ThrowingCopy(const ThrowingCopy& other) : value(other.value)
+    {
+        if (copies_left-- == 0) {
+            throw std::runtime_error("copy failed");
+        }
+    }
+    std::string value;
+};
+
+int ThrowingCopy::copies_left = 0;
+
+//default construction throws once constructions_left runs out
+struct ThrowingDefault
+{
+    static int constructions_left;
+
+    ThrowingDefault() : value("default")
+    {
+        if (constructions_left-- == 0) {
+            throw std::runtime_error("construction failed");
+        }
+    }
+    std::string value;
+};
+
+int ThrowingDefault::constructions_left = 0;
+
+namespace atl {
+template <> struct is_trivially_relocatable<UniqueHolder> : std::true_type {};
+template <> struct is_trivially_equality_comparable<Fingerprint> : std::true_type {};
+}
+
 TEST_CASE("Constructors", "[create]")
 {
     SECTION("vector(size_type n)")
@@ -102,6 +160,40 @@ TEST_CASE("Constructors", "[create]")
         REQUIRE(test_vector_a[5] == 12);
     }
 
+    SECTION("move constructor steals the buffer")
+    {
+        REQUIRE(std::is_nothrow_move_constructible<atl::vector<std::string>>::value);
+        REQUIRE(std::is_nothrow_move_assignable<atl::vector<std::string>>::value);
+        REQUIRE(noexcept(std::declval<atl::vector<int>&>().swap(std::declval<atl::vector<int>&>())));
+
+        atl::vector<std::string> source = {"a", "b", "c"};
+        auto data = source.data();
+
+        atl::vector<std::string> target(std::move(source));
+        REQUIRE(target.data() == data);
+        REQUIRE(target.size() == 3);
+        REQUIRE(source.empty());
+        REQUIRE(source.capacity() == 0);
+
+        source.push_back("reused");
+        REQUIRE(source[0] == "reused");
+
+        atl::vector<std::string> assigned;
+        assigned = std::move(target);
+        REQUIRE(assigned.data() == data);
+        REQUIRE(target.empty());
+    }
+
+    SECTION("allocator-extended move constructor")
+    {
+        atl::vector<std::string> source = {"a", "b"};
+        auto data = source.data();
+
+        atl::vector<std::string> target(std::move(source), std::allocator<std::string>());
+        REQUIRE(target.data() == data);
+        REQUIRE(target[1] == "b");
+    }
+
     SECTION("initializer_list constructors")
     {
         atl::vector<int> test_vector = {10, 12, 13, 199821};
@@ -230,6 +322,29 @@ TEST_CASE("Modify", "[modify]")
         for (auto& val : test_vector) {
             REQUIRE(val == 98);
         }
+
+        atl::vector<std::string> strings = {"a"};
+        strings.resize(20);
+        REQUIRE(strings.size() == 20);
+        REQUIRE(strings[0] == "a");
+        REQUIRE(strings[19].empty());
+        strings[19] = "constructed";
+        REQUIRE(strings[19] == "constructed");
+    }
+
+    SECTION("resize with a throwing constructor keeps the constructed prefix")
+    {
+        ThrowingDefault::constructions_left = 2;
+        atl::vector<ThrowingDefault> test_vector;
+        REQUIRE_THROWS_AS(test_vector.resize(5), std::runtime_error);
+        REQUIRE(test_vector.size() == 2);
+        REQUIRE(test_vector[1].value == "default");
+
+        atl::vector<ThrowingCopy> copies;
+        ThrowingCopy::copies_left = 3;
+        REQUIRE_THROWS_AS(copies.resize(5, "x"), std::runtime_error);
+        REQUIRE(copies.size() == 3);
+        REQUIRE(copies[2].value == "x");
     }
 
     SECTION("shrink_to_fit")
@@ -461,6 +576,372 @@ TEST_CASE("Modify", "[modify]")
     }
 }
 
+TEST_CASE("erase_if", "[modify]")
+{
+    SECTION("arithmetic")
+    {
+        atl::vector<int> test_vector;
+        std::vector<int> std_vector;
+        for (int i = 0; i < 1000; i++) {
+            test_vector.push_back(i * 7 % 13);
+            std_vector.push_back(i * 7 % 13);
+        }
+
+        auto removed = atl::erase_if(test_vector, [](int v) { return v % 3 == 0; });
+        auto expected = std_vector.size();
+        std_vector.erase(std::remove_if(std_vector.begin(), std_vector.end(), [](int v) { return v % 3 == 0; }),
+                         std_vector.end());
+
+        REQUIRE(removed == expected - std_vector.size());
+        REQUIRE(is_same(test_vector, std_vector));
+
+        REQUIRE(atl::erase(test_vector, 1) == static_cast<std::size_t>(std::count(std_vector.begin(), std_vector.end(), 1)));
+        REQUIRE(std::find(test_vector.begin(), test_vector.end(), 1) == test_vector.end());
+    }
+
+    SECTION("non trivial elements")
+    {
+        atl::vector<std::string> test_vector = {"keep", "drop", "drop", "keep2", "drop", "keep3"};
+        REQUIRE(atl::erase(test_vector, std::string("drop")) == 3);
+        REQUIRE(test_vector.size() == 3);
+        REQUIRE(test_vector[0] == "keep");
+        REQUIRE(test_vector[1] == "keep2");
+        REQUIRE(test_vector[2] == "keep3");
+
+        REQUIRE(atl::erase_if(test_vector, [](const std::string&) { return false; }) == 0);
+        REQUIRE(atl::erase_if(test_vector, [](const std::string&) { return true; }) == 3);
+        REQUIRE(test_vector.empty());
+        REQUIRE(atl::erase_if(test_vector, [](const std::string&) { return true; }) == 0);
+    }
+}
+
+TEST_CASE("unordered_erase", "[modify]")
+{
+    SECTION("single element")
+    {
+        atl::vector<std::string> test_vector = {"a", "b", "c", "d"};
+        auto it = test_vector.unordered_erase(test_vector.begin() + 1);
+        REQUIRE(*it == "d");
+        REQUIRE(test_vector.size() == 3);
+        REQUIRE(test_vector[0] == "a");
+        REQUIRE(test_vector[2] == "c");
+
+        it = test_vector.unordered_erase(test_vector.end() - 1);
+        REQUIRE(it == test_vector.end());
+        REQUIRE(test_vector.size() == 2);
+    }
+
+    SECTION("predicate")
+    {
+        atl::vector<int> test_vector;
+        for (int i = 0; i < 1000; i++) {
+            test_vector.push_back(i);
+        }
+
+        REQUIRE(test_vector.unordered_erase_if([](int v) { return v % 3 != 0; }) == 666);
+        REQUIRE(test_vector.size() == 334);
+        REQUIRE(std::all_of(test_vector.begin(), test_vector.end(), [](int v) { return v % 3 == 0; }));
+
+        std::vector<int> sorted(test_vector.begin(), test_vector.end());
+        std::sort(sorted.begin(), sorted.end());
+        for (std::size_t i = 0; i < sorted.size(); i++) {
+            REQUIRE(sorted[i] == static_cast<int>(i) * 3);
+        }
+    }
+
+    SECTION("batched indices")
+    {
+        atl::vector<UniqueHolder> test_vector;
+        for (int i = 0; i < 10; i++) {
+            test_vector.emplace_back(i);
+        }
+
+        REQUIRE(test_vector.unordered_erase_indices({0, 3, 8, 9}) == 4);
+
+        std::vector<int> values;
+        for (auto& holder : test_vector) {
+            values.push_back(*holder.value);
+        }
+        std::sort(values.begin(), values.end());
+        REQUIRE(values == std::vector<int>{1, 2, 4, 5, 6, 7});
+    }
+}
+
+TEST_CASE("Batched edits", "[modify]")
+{
+    SECTION("insert_many with growth")
+    {
+        atl::vector<std::string> test_vector = {"a", "b", "c"};
+        test_vector.shrink_to_fit();
+
+        test_vector.insert_many({0, 1, 1, 3}, {"w", "x", "y", "z"});
+        REQUIRE(is_same(test_vector, std::vector<std::string>{"w", "a", "x", "y", "b", "c", "z"}));
+    }
+
+    SECTION("insert_many in place")
+    {
+        atl::vector<int> test_vector;
+        std::vector<int> std_vector;
+        test_vector.reserve(200);
+        for (int i = 0; i < 100; i++) {
+            test_vector.push_back(i);
+            std_vector.push_back(i);
+        }
+        auto data = test_vector.data();
+
+        std::vector<std::size_t> positions = {0, 5, 5, 17, 50, 99, 100, 100};
+        std::vector<int> values = {-1, -2, -3, -4, -5, -6, -7, -8};
+        test_vector.insert_many(positions.begin(), positions.end(), values.begin());
+        for (auto i = positions.size(); i-- > 0;) {
+            std_vector.insert(std_vector.begin() + positions[i], values[i]);
+        }
+
+        REQUIRE(test_vector.data() == data);
+        REQUIRE(is_same(test_vector, std_vector));
+    }
+
+    SECTION("insert_many moves values")
+    {
+        atl::vector<std::string> test_vector = {"a", "b"};
+        test_vector.reserve(10);
+        std::vector<std::string> values = {"x", "y"};
+
+        test_vector.insert_many({}, {});
+        REQUIRE_THROWS_AS(test_vector.insert_many({1, 2}, {"x"}), std::invalid_argument);
+        REQUIRE(test_vector.size() == 2);
+
+        std::vector<std::size_t> positions = {1, 2};
+        test_vector.insert_many(positions.begin(), positions.end(), std::make_move_iterator(values.begin()));
+        REQUIRE(is_same(test_vector, std::vector<std::string>{"a", "x", "b", "y"}));
+        REQUIRE(values[0].empty());
+    }
+
+    SECTION("erase_indices")
+    {
+        atl::vector<std::string> test_vector;
+        std::vector<std::string> std_vector;
+        for (int i = 0; i < 50; i++) {
+            test_vector.push_back(std::to_string(i));
+            std_vector.push_back(std::to_string(i));
+        }
+
+        std::vector<std::size_t> indices = {0, 1, 7, 8, 9, 30, 49};
+        REQUIRE(test_vector.erase_indices(indices.begin(), indices.end()) == indices.size());
+        for (auto i = indices.size(); i-- > 0;) {
+            std_vector.erase(std_vector.begin() + indices[i]);
+        }
+        REQUIRE(is_same(test_vector, std_vector));
+
+        REQUIRE(test_vector.erase_indices({}) == 0);
+        REQUIRE(test_vector.erase_indices({42}) == 1);
+        REQUIRE(test_vector.size() == 42);
+    }
+
+    SECTION("insert_many with a throwing copy")
+    {
+        ThrowingCopy::copies_left = 100;
+        atl::vector<ThrowingCopy> test_vector = {"a", "b", "c"};
+        test_vector.shrink_to_fit();
+        auto data = test_vector.data();
+        std::vector<ThrowingCopy> values = {"w", "x", "y", "z"};
+        std::vector<std::size_t> positions = {0, 1, 1, 3};
+
+        //growing leaves the vector untouched
+        ThrowingCopy::copies_left = 2;
+        REQUIRE_THROWS_AS(test_vector.insert_many(positions.begin(), positions.end(), values.begin()), std::runtime_error);
+        REQUIRE(test_vector.data() == data);
+        REQUIRE(test_vector.size() == 3);
+        REQUIRE(test_vector[0].value + test_vector[1].value + test_vector[2].value == "abc");
+
+        //in place every old element survives, with the values placed before the throw
+        test_vector.reserve(10);
+        ThrowingCopy::copies_left = 2;
+        REQUIRE_THROWS_AS(test_vector.insert_many(positions.begin(), positions.end(), values.begin()), std::runtime_error);
+        std::string contents;
+        for (const auto& element : test_vector) {
+            contents += element.value;
+        }
+        REQUIRE(contents == "aybcz");
+    }
+}
+
+TEST_CASE("Capacity reuse", "[access]")
+{
+    SECTION("copy assignment keeps the existing buffer")
+    {
+        atl::vector<std::string> source = {"a", "b", "c"};
+        atl::vector<std::string> target = {"1", "2", "3", "4", "5"};
+        auto data = target.data();
+
+        target = source;
+        REQUIRE(target.data() == data);
+        REQUIRE(target.capacity() == 5);
+        REQUIRE(is_same(target, source));
+
+        source.push_back("d");
+        source.push_back("e");
+        target = source;
+        REQUIRE(target.data() == data);
+        REQUIRE(is_same(target, source));
+    }
+
+    SECTION("assign reuses capacity")
+    {
+        atl::vector<std::string> test_vector;
+        test_vector.reserve(10);
+        auto data = test_vector.data();
+
+        std::vector<std::string> values = {"x", "y", "z"};
+        for (int i = 0; i < 5; i++) {
+            test_vector.assign(values.begin(), values.begin() + 1 + i % 3);
+            test_vector.assign(4, "w");
+            test_vector.assign({"p", "q"});
+        }
+
+        REQUIRE(test_vector.data() == data);
+        REQUIRE(test_vector.size() == 2);
+        REQUIRE(test_vector[1] == "q");
+    }
+
+    SECTION("assign from an element of the same vector")
+    {
+        atl::vector<std::string> test_vector = {"keep", "b"};
+        test_vector.assign(20, test_vector[0]);
+        REQUIRE(test_vector.size() == 20);
+        REQUIRE(test_vector[19] == "keep");
+    }
+}
+
+TEST_CASE("Growth policy", "[modify]")
+{
+    SECTION("default policy does not allocate empty vectors")
+    {
+        atl::vector<int> test_vector;
+        REQUIRE(test_vector.capacity() == 0);
+        REQUIRE(test_vector.data() == nullptr);
+
+        test_vector.push_back(1);
+        REQUIRE(test_vector.capacity() == 10);
+    }
+
+    SECTION("eager policy")
+    {
+        using Policy = atl::basic_growth_policy<2, 1, 4, true>;
+        atl::vector<int, std::allocator<int>, Policy> test_vector;
+        REQUIRE(test_vector.capacity() == 4);
+
+        for (int i = 0; i < 5; i++) {
+            test_vector.push_back(i);
+        }
+        REQUIRE(test_vector.capacity() == 8);
+        REQUIRE(*(test_vector.begin() + 4) == 4);
+    }
+
+    SECTION("page rounding")
+    {
+        atl::vector<int, std::allocator<int>, atl::page_growth_policy<>> test_vector;
+        test_vector.push_back(1);
+        REQUIRE(test_vector.capacity() == 4096 / sizeof(int));
+
+        test_vector.reserve(1025);
+        REQUIRE(test_vector.capacity() == 2 * 4096 / sizeof(int));
+    }
+
+    SECTION("size class rounding")
+    {
+        atl::vector<char, std::allocator<char>, atl::size_class_growth_policy> test_vector;
+        test_vector.reserve(100);
+        REQUIRE(test_vector.capacity() == 128);
+    }
+
+    SECTION("bulk insert grows geometrically")
+    {
+        atl::vector<int> test_vector(100, 1);
+        test_vector.insert(test_vector.end(), 2, 5);
+        REQUIRE(test_vector.capacity() == 150);
+    }
+}
+
+TEST_CASE("Relocation", "[modify]")
+{
+    SECTION("trivially copyable")
+    {
+        REQUIRE(atl::is_trivially_relocatable_v<int>);
+        REQUIRE_FALSE(atl::is_trivially_relocatable_v<NotIntegralType>);
+
+        atl::vector<int> test_vector;
+        for (int i = 0; i < 1000; i++) {
+            test_vector.push_back(i);
+        }
+
+        test_vector.reserve(5000);
+        for (int i = 0; i < 1000; i++) {
+            REQUIRE(test_vector[i] == i);
+        }
+    }
+
+    SECTION("insert and erase shift the tail")
+    {
+        atl::vector<std::string> test_vector = {"a", "b", "c", "d", "e"};
+        std::vector<std::string> std_vector = {"a", "b", "c", "d", "e"};
+
+        test_vector.insert(test_vector.begin() + 1, {"x", "y"});
+        std_vector.insert(std_vector.begin() + 1, {"x", "y"});
+        REQUIRE(is_same(test_vector, std_vector));
+
+        test_vector.insert(test_vector.end() - 1, 4, "z");
+        std_vector.insert(std_vector.end() - 1, 4, "z");
+        REQUIRE(is_same(test_vector, std_vector));
+
+        test_vector.erase(test_vector.begin() + 2, test_vector.begin() + 6);
+        std_vector.erase(std_vector.begin() + 2, std_vector.begin() + 6);
+        REQUIRE(is_same(test_vector, std_vector));
+
+        test_vector.erase(test_vector.begin());
+        std_vector.erase(std_vector.begin());
+        REQUIRE(is_same(test_vector, std_vector));
+    }
+
+    SECTION("erase from opt-in trivially relocatable")
+    {
+        atl::vector<UniqueHolder> test_vector;
+        for (int i = 0; i < 10; i++) {
+            test_vector.emplace_back(i);
+        }
+
+        test_vector.erase(test_vector.begin() + 2, test_vector.begin() + 5);
+        test_vector.emplace(test_vector.begin(), 42);
+
+        REQUIRE(test_vector.size() == 8);
+        REQUIRE(*test_vector[0].value == 42);
+        REQUIRE(*test_vector[3].value == 5);
+        REQUIRE(*test_vector[7].value == 9);
+    }
+
+    SECTION("opt-in trivially relocatable")
+    {
+        atl::vector<UniqueHolder> test_vector;
+        for (int i = 0; i < 100; i++) {
+            test_vector.emplace_back(i);
+        }
+
+        test_vector.shrink_to_fit();
+        REQUIRE(test_vector.capacity() == 100);
+        for (int i = 0; i < 100; i++) {
+            REQUIRE(*test_vector[i].value == i);
+        }
+    }
+
+    SECTION("non trivially relocatable")
+    {
+        atl::vector<NotIntegralType> test_vector(3);
+        test_vector[2].large_field_a[0] = 42;
+
+        test_vector.reserve(50);
+        REQUIRE(test_vector[2].large_field_a[0] == 42);
+    }
+}
+
 TEST_CASE("Operators")
 {
     SECTION("copy assignment = ")
@@ -574,6 +1055,93 @@ TEST_CASE("Operators")
 
         REQUIRE(test_vector_a != test_vector_b);
     }
+
+    SECTION("lexicographic order")
+    {
+        atl::vector<int> test_vector_a = {2, 1};
+        atl::vector<int> test_vector_b = {1, 5};
+        REQUIRE_FALSE(test_vector_a < test_vector_b);
+        REQUIRE_FALSE(test_vector_a <= test_vector_b);
+        REQUIRE(test_vector_a > test_vector_b);
+        REQUIRE(test_vector_a >= test_vector_b);
+
+        atl::vector<std::string> strings_a = {"b", "a"};
+        atl::vector<std::string> strings_b = {"a", "z"};
+        REQUIRE_FALSE(strings_a < strings_b);
+        REQUIRE_FALSE(strings_a <= strings_b);
+        REQUIRE(strings_b < strings_a);
+
+        atl::vector<int> prefix = {1, 2};
+        atl::vector<int> longer = {1, 2, 0};
+        REQUIRE(prefix < longer);
+        REQUIRE(prefix <= longer);
+        REQUIRE_FALSE(longer <= prefix);
+        REQUIRE(atl::vector<int>() < prefix);
+        REQUIRE(atl::vector<int>() <= atl::vector<int>());
+        REQUIRE_FALSE(atl::vector<int>() < atl::vector<int>());
+    }
+
+    SECTION("ordering fast paths agree with std::lexicographical_compare")
+    {
+        auto check = [](const auto& lhs, const auto& rhs) {
+            auto less = std::lexicographical_compare(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
+            auto greater = std::lexicographical_compare(rhs.begin(), rhs.end(), lhs.begin(), lhs.end());
+            return (lhs < rhs) == less && (lhs > rhs) == greater && (lhs <= rhs) == !greater && (lhs >= rhs) == !less;
+        };
+
+        atl::vector<std::uint8_t> bytes_a(1000, 7);
+        atl::vector<std::uint8_t> bytes_b(1000, 7);
+        REQUIRE(check(bytes_a, bytes_b));
+        bytes_b[998] = 200;
+        REQUIRE(check(bytes_a, bytes_b));
+        bytes_a[3] = 255;
+        REQUIRE(check(bytes_a, bytes_b));
+        bytes_b.resize(3);
+        REQUIRE(check(bytes_a, bytes_b));
+
+        atl::vector<std::int32_t> ints_a(1000, -1);
+        atl::vector<std::int32_t> ints_b(1000, -1);
+        REQUIRE(check(ints_a, ints_b));
+        for (std::size_t i : {999, 517, 64, 15, 0}) {
+            ints_b[i] = 1 - static_cast<std::int32_t>(i);
+            REQUIRE(check(ints_a, ints_b));
+            REQUIRE(check(ints_b, ints_a));
+        }
+
+        atl::vector<double> doubles_a = {1.0, std::nan(""), 2.0};
+        atl::vector<double> doubles_b = {1.0, 5.0, 3.0};
+        REQUIRE(check(doubles_a, doubles_b));
+        REQUIRE(check(doubles_b, doubles_a));
+
+        atl::vector<char> chars_a = {'a', static_cast<char>(-5)};
+        atl::vector<char> chars_b = {'a', 'b'};
+        REQUIRE(check(chars_a, chars_b));
+    }
+
+    SECTION("== on trivially equality comparable types")
+    {
+        REQUIRE(atl::is_trivially_equality_comparable_v<std::uint64_t>);
+        REQUIRE(atl::is_trivially_equality_comparable_v<Fingerprint>);
+        REQUIRE_FALSE(atl::is_trivially_equality_comparable_v<double>);
+        REQUIRE_FALSE(atl::is_trivially_equality_comparable_v<SomeClass>);
+
+        atl::vector<std::uint64_t> test_vector_a(100000, 7);
+        atl::vector<std::uint64_t> test_vector_b(100000, 7);
+        REQUIRE(test_vector_a == test_vector_b);
+
+        test_vector_b[99999] = 8;
+        REQUIRE(test_vector_a != test_vector_b);
+
+        atl::vector<Fingerprint> prints_a = {{1, 2}, {3, 4}};
+        atl::vector<Fingerprint> prints_b = {{1, 2}, {3, 4}};
+        REQUIRE(prints_a == prints_b);
+        prints_b[1].low = 5;
+        REQUIRE(prints_a != prints_b);
+
+        atl::vector<double> zeros_a = {0.0};
+        atl::vector<double> zeros_b = {-0.0};
+        REQUIRE(zeros_a == zeros_b);
+    }
 }
 
 TEST_CASE("Iterators")